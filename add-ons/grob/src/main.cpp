@@ -444,7 +444,7 @@ int main(int argc, const char * argv[]) {
         
         if (extension == ".prgm" || extension == ".hpprgm") {
             if (extension == ".hpprgm") {
-                hpprgm::create(outpath, "", utf8);
+                hpprgm::create(outpath, utf8);
             } else {
                 std::wstring utf16 = utf::utf16(utf8);
                 utf::save(outpath, utf16);
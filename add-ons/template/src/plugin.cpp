@@ -0,0 +1,82 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ In-process entry point for the add-on, see src/plugin_abi.h in ppl+.
+ 
+ Build with `make plugin` and install the library next to ppl+. Here the conversion
+ is the same as the executable's, the file contents are passed through unchanged.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../version_code.h"
+#include "../../../src/plugin_abi.h"
+
+// MARK: - Functions
+
+static std::string convert(const std::string& filename, const std::string& content)
+{
+    return content;
+}
+
+// MARK: - Add-On Interface
+
+static int addonConvert(const char* filename, const unsigned char* data, size_t size, char** output, size_t* length)
+{
+    std::string text;
+    int status = 0;
+    
+    try {
+        text = convert(filename, std::string(reinterpret_cast<const char*>(data), size));
+    } catch (const std::exception& e) {
+        text = e.what();
+        status = 1;
+    }
+    
+    *output = static_cast<char*>(std::malloc(text.size() + 1));
+    if (!*output) return 1;
+    std::memcpy(*output, text.c_str(), text.size() + 1);
+    *length = text.size();
+    
+    return status;
+}
+
+static void addonRelease(char* output)
+{
+    std::free(output);
+}
+
+const pplplus_addon_t* pplplus_addon(void)
+{
+    static const pplplus_addon_t addon = {
+        PPLPLUS_ADDON_ABI_VERSION,
+        NUMERIC_BUILD,
+        addonConvert,
+        addonRelease
+    };
+    return &addon;
+}
@@ -0,0 +1,380 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ Micro-benchmarks for the hot library functions used by the translator.
+
+ Usage: ppl+-bench [--filter <text>] [--save <file>] [--compare <file>] [--threshold <percent>]
+
+ Each benchmark is calibrated so that a single sample runs for at least
+ SAMPLE_TIME nanoseconds, the median of SAMPLES samples is reported as the
+ time per operation. With --compare, the run fails (exit code 1) if any
+ benchmark is slower than its baseline by more than the threshold.
+
+ Timings only compare on the machine that recorded them, so the baseline is
+ not kept in the repository: record one with `make bench-baseline` before
+ making a change, then check the change with `make bench-compare`.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+
+#include "timer.hpp"
+#include "singleton.hpp"
+#include "aliases.hpp"
+#include "regexp.hpp"
+#include "calc.hpp"
+#include "code_stack.hpp"
+#include "dictionary.hpp"
+#include "utf.hpp"
+#include "hpprgm.hpp"
+#include "minifier.hpp"
+#include "reformatter.hpp"
+
+#define SAMPLES 7
+#define SAMPLE_TIME 20000000LL
+
+namespace fs = std::filesystem;
+
+using pplplus::Singleton;
+using pplplus::Aliases;
+using pplplus::Regexp;
+using pplplus::Calc;
+using pplplus::CodeStack;
+using pplplus::Dictionary;
+using pplplus::Minifier;
+using pplplus::Reformatter;
+
+typedef struct {
+    std::string name;
+    std::function<void()> run;
+} benchmark_t;
+
+static std::vector<benchmark_t> benchmarks;
+
+// Keeps the optimizer from discarding results of the code being measured.
+static volatile size_t sink = 0;
+
+static fs::path workingDir(void) {
+    static fs::path path = fs::temp_directory_path() / "ppl+-bench";
+    fs::create_directories(path);
+    return path;
+}
+
+// MARK: - Sample Data
+
+static std::string sampleProgram(size_t lines) {
+    std::string code;
+    code.reserve(lines * 48);
+
+    code += "EXPORT Main()\nBEGIN\n";
+    for (size_t n = 0; n < lines; n++) {
+        code += "  LOCAL v" + std::to_string(n) + " := \"π ≥ θ\" + " + std::to_string(n) + "; // ✓\n";
+    }
+    code += "END;\n";
+
+    return code;
+}
+
+// A UTF-16LE file of about 5 MB, as exported by the Connectivity Kit.
+static fs::path largeUTF16File(const std::wstring& wprogram) {
+    static fs::path path = [&wprogram] {
+        fs::path path = workingDir() / "large.prgm";
+        std::wstring wstr;
+        while (wstr.size() * sizeof(char16_t) < 5 * 1024 * 1024) wstr += wprogram;
+        utf::save(path, wstr, utf::BOMle);
+        return path;
+    }();
+    return path;
+}
+
+static Aliases::TIdentity identity(const std::string& identifier, const std::string& real) {
+    Aliases::TIdentity identity;
+    identity.identifier = identifier;
+    identity.real = real;
+    identity.type = Aliases::Type::Alias;
+    identity.scope = 0;
+    return identity;
+}
+
+// MARK: - Benchmarks
+
+static void registerBenchmarks(void) {
+    static const std::string program = sampleProgram(1000);
+    static const std::wstring wprogram = utf::utf16(program);
+
+    benchmarks.push_back({"utf::utf16", [] {
+        sink = sink + utf::utf16(program).size();
+    }});
+
+    benchmarks.push_back({"utf::utf8", [] {
+        sink = sink + utf::utf8(wprogram).size();
+    }});
+
+    benchmarks.push_back({"utf::save", [] {
+        static fs::path path = workingDir() / "save.prgm";
+        sink = sink + utf::save(path, wprogram, utf::BOMle);
+    }});
+
+    benchmarks.push_back({"Aliases::append", [] {
+        Aliases aliases;
+        for (int n = 0; n < 200; n++) {
+            sink = sink + aliases.append(identity("alias" + std::to_string(n), "real" + std::to_string(n)));
+        }
+    }});
+
+    benchmarks.push_back({"Aliases::resolveAllAliasesInText", [] {
+        static Aliases aliases = [] {
+            Aliases aliases;
+            for (int n = 0; n < 200; n++) {
+                aliases.append(identity("alias" + std::to_string(n), "real" + std::to_string(n)));
+            }
+            return aliases;
+        }();
+        sink = sink + aliases.resolveAllAliasesInText("LOCAL a := alias7 + alias42 * alias199; // \"alias1\"").size();
+    }});
+
+    benchmarks.push_back({"Regexp::resolveAllRegularExpression", [] {
+        static Regexp regexp = [] {
+            Regexp regexp;
+            for (int n = 0; n < 20; n++) {
+                regexp.parse("regex `\\brule" + std::to_string(n) + " +([a-z]+)\\b`i IF $1 THEN");
+            }
+            return regexp;
+        }();
+        std::string str = "  rule19 ready";
+        regexp.resolveAllRegularExpression(str);
+        sink = sink + str.size();
+    }});
+
+    benchmarks.push_back({"Calc::evaluateMathExpression", [] {
+        sink = sink + Calc::evaluateMathExpression("2*π/360+#FF:32h*(3-1)").size();
+    }});
+
+    benchmarks.push_back({"Calc::parse", [] {
+        sink = sink + Calc::parse("LOCAL a := \\`1+2*3/4`:2 + b;").size();
+    }});
+
+    benchmarks.push_back({"CodeStack::parse", [] {
+        static CodeStack codeStack;
+        sink = sink + codeStack.parse("__PUSH__`i := i + 1;` WHILE i < 10 DO __TOP__ __POP__ END;").size();
+    }});
+
+    benchmarks.push_back({"Dictionary::proccessDictionaryDefinition", [] {
+        sink = sink + Dictionary::proccessDictionaryDefinition("dict width:=320, height:=240, depth:=16 screen;");
+        Singleton::shared()->aliases.removeAllAliasesOfType(Aliases::Type::Alias);
+    }});
+
+    benchmarks.push_back({"utf::write", [] {
+        static fs::path path = workingDir() / "write.prgm";
+        std::ofstream os(path, std::ios::out | std::ios::binary);
+        sink = sink + utf::write(os, std::string_view(program), utf::BOMle);
+    }});
+
+    benchmarks.push_back({"utf::load/utf16-5MB", [] {
+        sink = sink + utf::load(largeUTF16File(wprogram), utf::BOMle).size();
+    }});
+
+    benchmarks.push_back({"utf::loadText/utf16-5MB", [] {
+        sink = sink + utf::loadText(largeUTF16File(wprogram)).size();
+    }});
+
+    benchmarks.push_back({"hpprgm::create", [] {
+        static fs::path path = workingDir() / "create.hpprgm";
+        hpprgm::create(path, program);
+        sink = sink + 1;
+    }});
+
+    benchmarks.push_back({"hpprgm::prgm", [] {
+        static fs::path path = [] {
+            fs::path path = workingDir() / "prgm.hpprgm";
+            hpprgm::create(path, program);
+            return path;
+        }();
+        sink = sink + hpprgm::prgm(path).size();
+    }});
+
+    benchmarks.push_back({"hpprgm::load", [] {
+        static fs::path path = [] {
+            fs::path path = workingDir() / "load.hpprgm";
+            hpprgm::create(path, program);
+            return path;
+        }();
+        sink = sink + hpprgm::load(path).size();
+    }});
+
+    benchmarks.push_back({"Minifier::minify", [] {
+        Minifier minifier;
+        sink = sink + minifier.minify(program).size();
+    }});
+
+    benchmarks.push_back({"Reformatter::reformat", [] {
+        Reformatter reformatter;
+        sink = sink + reformatter.reformat(program).size();
+    }});
+
+    benchmarks.push_back({"Reformatter::reformat/cached", [] {
+        static Reformatter reformatter;
+        sink = sink + reformatter.reformat(program).size();
+    }});
+}
+
+// MARK: - Measuring
+
+static double measure(const std::function<void()>& run) {
+    // Calibrate the number of iterations needed for a single sample.
+    long long iterations = 1;
+    while (true) {
+        Timer timer;
+        for (long long n = 0; n < iterations; n++) run();
+        if (timer.elapsed() >= SAMPLE_TIME) break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    for (int s = 0; s < SAMPLES; s++) {
+        Timer timer;
+        for (long long n = 0; n < iterations; n++) run();
+        samples.push_back(static_cast<double>(timer.elapsed()) / iterations);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples.at(SAMPLES / 2);
+}
+
+static std::map<std::string, double> loadBaseline(const fs::path& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream is(path);
+    std::string line;
+
+    while (getline(is, line)) {
+        if (line.empty() || line.front() == '#') continue;
+        std::istringstream iss(line);
+        std::string name;
+        double ns;
+        if (iss >> name >> ns) baseline[name] = ns;
+    }
+
+    return baseline;
+}
+
+// MARK: - Command Line
+
+static void help(void) {
+    std::cerr
+    << "Usage: ppl+-bench [--filter <text>] [--save <file>] [--compare <file>] [--threshold <percent>]\n"
+    << "\n"
+    << "Options:\n"
+    << "  --filter <text>         Only run benchmarks whose name contains <text>.\n"
+    << "  --save <file>           Write the results as a new baseline.\n"
+    << "  --compare <file>        Fail if a result regresses beyond the threshold.\n"
+    << "  --threshold <percent>   Allowed regression in percent, default is 25.\n";
+}
+
+int main(int argc, char **argv) {
+    std::string filter;
+    fs::path save, compare;
+    double threshold = 25.0;
+
+    for (int n = 1; n < argc; n++) {
+        std::string args = argv[n];
+
+        if (args == "--help") {
+            help();
+            return 0;
+        }
+
+        if (n + 1 >= argc) {
+            help();
+            return 2;
+        }
+
+        if (args == "--filter") filter = argv[++n];
+        else if (args == "--save") save = argv[++n];
+        else if (args == "--compare") compare = argv[++n];
+        else if (args == "--threshold") threshold = atof(argv[++n]);
+        else {
+            help();
+            return 2;
+        }
+    }
+
+    registerBenchmarks();
+
+    std::map<std::string, double> baseline;
+    if (!compare.empty()) {
+        baseline = loadBaseline(compare);
+        if (baseline.empty()) {
+            std::cerr << "❌ error: Unable to load baseline " << compare.filename() << ".\n";
+            return 2;
+        }
+    }
+
+    std::ostringstream results;
+    int regressions = 0;
+
+    for (const benchmark_t& benchmark : benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+
+        double ns = measure(benchmark.run);
+        results << benchmark.name << " " << std::fixed << std::setprecision(1) << ns << "\n";
+
+        std::cout << std::left << std::setw(44) << benchmark.name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns/op";
+
+        auto it = baseline.find(benchmark.name);
+        if (it != baseline.end()) {
+            double change = (ns - it->second) * 100.0 / it->second;
+            std::cout << std::setw(9) << std::showpos << std::setprecision(1) << change << "%" << std::noshowpos;
+            if (change > threshold) {
+                std::cout << " ❌ regression";
+                regressions++;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    if (!save.empty()) {
+        std::ofstream os(save);
+        os << "# ppl+-bench baseline, ns/op\n" << results.str();
+        std::cerr << "Baseline saved to " << save.filename() << "\n";
+    }
+
+    fs::remove_all(workingDir());
+
+    if (regressions) {
+        std::cerr << "🛑 " << regressions << " benchmark(s) regressed beyond " << threshold << "%\n";
+        return 1;
+    }
+
+    return 0;
+}
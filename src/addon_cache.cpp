@@ -0,0 +1,168 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "addon_cache.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+
+#include "source.hpp"
+#include "plugin.hpp"
+
+using pplplus::AddonCache;
+
+// MARK: - Hashing
+
+/*
+ 128-bit content hash made of two independent 64-bit hashes, FNV-1a and a
+ multiply-rotate hash, so that an accidental collision needs both to collide.
+ */
+typedef struct {
+    uint64_t a = 0xcbf29ce484222325ULL;
+    uint64_t b = 0x9e3779b97f4a7c15ULL;
+} hash_t;
+
+static void hash(hash_t& h, std::string_view data) {
+    for (unsigned char c : data) {
+        h.a = (h.a ^ c) * 0x100000001b3ULL;
+        h.b = ((h.b ^ c) * 0xff51afd7ed558ccdULL);
+        h.b ^= h.b >> 29;
+    }
+    
+    // Terminate each field so that "ab"+"c" and "a"+"bc" differ.
+    h.a = (h.a ^ 0xFF) * 0x100000001b3ULL;
+    h.b = ((h.b ^ data.size()) * 0xc4ceb9fe1a85ec53ULL);
+    h.b ^= h.b >> 32;
+}
+
+static std::string hex(const hash_t& h) {
+    char str[33];
+    snprintf(str, sizeof(str), "%016llx%016llx", static_cast<unsigned long long>(h.a), static_cast<unsigned long long>(h.b));
+    return str;
+}
+
+std::string AddonCache::key(const std::filesystem::path& path, const std::string& command, long build,
+                            const std::vector<std::string>& arguments) {
+    pplplus::Source source(path);
+    hash_t h;
+    
+    hash(h, source.view());
+    
+    // Add-ons such as grob name the generated variables after the file.
+    hash(h, path.filename().string());
+    hash(h, command);
+    hash(h, std::to_string(build));
+    for (const std::string& argument : arguments) {
+        hash(h, argument);
+    }
+    
+    return hex(h);
+}
+
+// MARK: - Cache
+
+long AddonCache::build(const std::string& command) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _builds.find(command);
+        if (it != _builds.end()) return it->second;
+    }
+    
+    long build = plugin::build(command);
+    if (build < 0) {
+        tool::result_t result = tool::runTool(command, {"--build"});
+        if (result.exitCode == 0 && !result.out.empty()) {
+            char* end = nullptr;
+            build = strtol(result.out.c_str(), &end, 10);
+            if (end == result.out.c_str()) build = -1;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    _builds[command] = build;
+    return build;
+}
+
+bool AddonCache::lookup(const std::string& key, std::string& output) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        output = it->second;
+        return true;
+    }
+    
+    if (directory.empty()) return false;
+    
+    std::ifstream is(directory / (key + ".ppl"), std::ios::in | std::ios::binary);
+    if (!is.is_open()) return false;
+    
+    output.assign((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    _entries[key] = output;
+    return true;
+}
+
+void AddonCache::store(const std::string& key, const std::string& output) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _entries[key] = output;
+    if (directory.empty()) return;
+    
+    // Written under a temporary name first so that a reader never sees a partial entry.
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    
+    std::filesystem::path path = directory / (key + ".ppl");
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    
+    std::ofstream os(temp, std::ios::out | std::ios::binary);
+    if (!os.is_open()) return;
+    os.write(output.data(), output.size());
+    os.close();
+    
+    std::filesystem::rename(temp, path, ec);
+    if (ec) std::filesystem::remove(temp, ec);
+}
+
+tool::result_t AddonCache::run(const std::string& command, const std::vector<std::string>& arguments,
+                               const std::filesystem::path& path,
+                               const std::function<tool::result_t(void)>& convert) {
+    long build = this->build(command);
+    
+    // Without a build number a changed add-on could not be told apart, so nothing is cached.
+    if (build < 0) return convert();
+    
+    std::string key = AddonCache::key(path, command, build, arguments);
+    
+    tool::result_t result{};
+    if (lookup(key, result.out)) return result;
+    
+    result = convert();
+    if (result.exitCode == 0) store(key, result.out);
+    
+    return result;
+}
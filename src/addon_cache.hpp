@@ -0,0 +1,75 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef addon_cache_hpp
+#define addon_cache_hpp
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <filesystem>
+
+#include "tool.hpp"
+
+namespace pplplus {
+    /*
+     Remembers the output of add-on conversions.
+     
+     A conversion depends only on the contents of the input file, the build of the
+     add-on and the arguments it is given, so these form the key. Results are kept in
+     memory for the life of the process and, when a directory is set, also on disk so
+     that later builds can reuse them. Only successful conversions are stored.
+     */
+    class AddonCache {
+    public:
+        // Directory for the on-disk cache, empty to cache in memory only.
+        std::filesystem::path directory;
+        
+        /*
+         Returns the output of the add-on command for the file, running it only if the
+         result is not already cached.
+         */
+        tool::result_t run(const std::string& command, const std::vector<std::string>& arguments,
+                           const std::filesystem::path& path,
+                           const std::function<tool::result_t(void)>& convert);
+        
+        // Build number of the add-on, or -1 if it could not be determined.
+        long build(const std::string& command);
+        
+        static std::string key(const std::filesystem::path& path, const std::string& command, long build,
+                               const std::vector<std::string>& arguments);
+        
+    private:
+        std::mutex _mutex;
+        std::map<std::string, std::string> _entries;
+        std::map<std::string, long> _builds;
+        
+        bool lookup(const std::string& key, std::string& output);
+        void store(const std::string& key, const std::string& output);
+    };
+}
+
+#endif /* addon_cache_hpp */
@@ -0,0 +1,186 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "batch.hpp"
+
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+
+#include "timer.hpp"
+#include "utf.hpp"
+#include "hpprgm.hpp"
+#include "reformatter.hpp"
+
+namespace fs = std::filesystem;
+
+using pplplus::Batch;
+
+static std::string lowercased(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    return str;
+}
+
+static bool isContainer(const fs::path& path) {
+    std::string ext = lowercased(path.extension().string());
+    return ext == ".hpprgm" || ext == ".hpappprgm";
+}
+
+Batch::Batch(const fs::path& dir, const fs::path& outdir) : _dir(dir), _outdir(outdir.empty() ? dir : outdir) {
+}
+
+void Batch::extract(result_t& result) const {
+    if (!result.error.empty()) return;
+    
+    Timer timer;
+    
+    try {
+        result.inSize = fs::file_size(result.inpath);
+        
+        std::string prgm = hpprgm::load(result.inpath);
+        if (prgm.empty()) {
+            result.error = "no program found";
+        } else {
+            if (reformat) {
+                pplplus::Reformatter reformatter;
+                prgm = reformatter.reformat(prgm);
+            }
+            
+            fs::create_directories(result.outpath.parent_path());
+            if (utf::save(result.outpath, std::string_view(prgm), utf::BOMle)) {
+                result.outSize = fs::file_size(result.outpath);
+            } else {
+                result.error = "unable to create file";
+            }
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    
+    result.elapsed = timer.elapsed();
+}
+
+size_t Batch::run(void) {
+    Timer timer;
+    std::error_code ec;
+    
+    _results.clear();
+    for (auto it = fs::recursive_directory_iterator(_dir, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file() || !isContainer(it->path())) continue;
+        
+        result_t result{};
+        result.inpath = it->path();
+        result.outpath = _outdir / fs::relative(it->path(), _dir);
+        result.outpath.replace_extension(".prgm");
+        _results.push_back(result);
+    }
+    std::sort(_results.begin(), _results.end(), [](const result_t& a, const result_t& b) {
+        return a.inpath < b.inpath;
+    });
+    
+    /*
+     X.hpprgm and X.hpappprgm side by side, as in Connectivity Kit backups, would both be
+     extracted to X.prgm, so the app's program goes to X.app.prgm instead. Any clash left,
+     such as between names differing only in case, is reported rather than overwritten.
+     */
+    std::unordered_map<std::string, size_t> outputs;
+    for (const result_t& result : _results) outputs[lowercased(result.outpath.string())]++;
+    for (result_t& result : _results) {
+        if (outputs[lowercased(result.outpath.string())] > 1 && lowercased(result.inpath.extension().string()) == ".hpappprgm") {
+            result.outpath.replace_extension(".app.prgm");
+        }
+    }
+    
+    std::unordered_map<std::string, const result_t*> claimed;
+    for (result_t& result : _results) {
+        auto [it, inserted] = claimed.try_emplace(lowercased(result.outpath.string()), &result);
+        if (!inserted) result.error = "same output file as " + fs::relative(it->second->inpath, _dir).string();
+    }
+    
+    _workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    _workers = std::min<unsigned>(_workers, std::max<size_t>(_results.size(), 1));
+    
+    // Each worker takes the next unclaimed file until none are left.
+    std::atomic<size_t> next = 0;
+    auto worker = [this, &next]() {
+        for (size_t n = next++; n < _results.size(); n = next++) {
+            extract(_results[n]);
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned n = 1; n < _workers; n++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    _elapsed = timer.elapsed();
+    
+    return std::count_if(_results.begin(), _results.end(), [](const result_t& result) {
+        return !result.error.empty();
+    });
+}
+
+void Batch::summary(std::ostream& os) const {
+    size_t inSize = 0, outSize = 0, failed = 0;
+    long long busy = 0;
+    const result_t* slowest = nullptr;
+    
+    for (const result_t& result : _results) {
+        busy += result.elapsed;
+        if (!slowest || result.elapsed > slowest->elapsed) slowest = &result;
+        
+        if (!result.error.empty()) {
+            failed++;
+            os << "❌ " << fs::relative(result.inpath, _dir).string() << ": " << result.error << "\n";
+            continue;
+        }
+        
+        inSize += result.inSize;
+        outSize += result.outSize;
+        
+        if (verbose) {
+            os << std::left << std::setw(40) << fs::relative(result.outpath, _outdir).string() << std::right
+               << std::setw(10) << result.inSize << " → " << std::setw(10) << result.outSize << " bytes"
+               << std::setw(10) << std::fixed << std::setprecision(2) << result.elapsed / 1e6 << " ms\n";
+        }
+    }
+    
+    os << "Extracted " << _results.size() - failed << " of " << _results.size() << " programs"
+       << " using " << _workers << " thread" << (_workers == 1 ? "" : "s") << "\n"
+       << "  Input:   " << inSize << " bytes\n"
+       << "  Output:  " << outSize << " bytes\n"
+       << "  Elapsed: " << std::fixed << std::setprecision(2) << _elapsed / 1e6 << " ms"
+       << " (" << busy / 1e6 << " ms across all threads)\n";
+    
+    if (slowest) {
+        os << "  Slowest: " << fs::relative(slowest->inpath, _dir).string()
+           << " (" << std::fixed << std::setprecision(2) << slowest->elapsed / 1e6 << " ms)\n";
+    }
+}
@@ -0,0 +1,81 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef batch_hpp
+#define batch_hpp
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+
+namespace pplplus {
+    /*
+     Extracts every .hpprgm and .hpappprgm found under a directory, such as a
+     Connectivity Kit backup, into .prgm text files.
+     
+     Files are shared out across a pool of worker threads. The directory structure is
+     kept, each output file being written to the same relative location in the output
+     directory.
+     */
+    class Batch {
+    public:
+        typedef struct {
+            std::filesystem::path inpath;
+            std::filesystem::path outpath;
+            size_t inSize;
+            size_t outSize;
+            long long elapsed;
+            std::string error;
+        } result_t;
+        
+        bool reformat = false;
+        bool verbose = false;
+        
+        // Number of worker threads, 0 uses one per hardware thread.
+        unsigned threads = 0;
+        
+        Batch(const std::filesystem::path& dir, const std::filesystem::path& outdir);
+        
+        // Extracts all programs and returns the number that failed.
+        size_t run(void);
+        
+        void summary(std::ostream& os) const;
+        
+        const std::vector<result_t>& results(void) const {
+            return _results;
+        }
+        
+    private:
+        std::filesystem::path _dir;
+        std::filesystem::path _outdir;
+        std::vector<result_t> _results;
+        long long _elapsed = 0;
+        unsigned _workers = 0;
+        
+        void extract(result_t& result) const;
+    };
+}
+
+#endif /* batch_hpp */
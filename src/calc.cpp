@@ -30,6 +30,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 
 using pplplus::Calc;
 
@@ -292,6 +293,196 @@ static void convertPPLStyleNumbersToBase10(std::string& str) {
 }
 
 
+// MARK: - Functions and Variables
+
+namespace {
+    /*
+     A recursive descent parser for the expressions of directives such as #table, which
+     unlike those of \`...` may call functions and use variables.
+     */
+    class Evaluator {
+    public:
+        Evaluator(const std::string& expression, const std::unordered_map<std::string, double>& variables, bool degrees)
+        : _str(expression), _variables(variables), _degrees(degrees) {}
+        
+        bool evaluate(double& result) {
+            result = expression();
+            skipSpaces();
+            if (_error.empty() && _pos < _str.size()) _error = "unexpected '" + _str.substr(_pos) + "'";
+            if (!_error.empty()) {
+                std::cerr << MessageType::Error << "'" << _str << "': " << _error << "\n";
+                return false;
+            }
+            return true;
+        }
+        
+    private:
+        const std::string& _str;
+        const std::unordered_map<std::string, double>& _variables;
+        bool _degrees;
+        size_t _pos = 0;
+        std::string _error;
+        
+        void skipSpaces(void) {
+            while (_pos < _str.size() && isspace(static_cast<unsigned char>(_str[_pos]))) _pos++;
+        }
+        
+        bool accept(const std::string& s) {
+            skipSpaces();
+            if (_str.compare(_pos, s.size(), s) != 0) return false;
+            _pos += s.size();
+            return true;
+        }
+        
+        bool acceptWord(const std::string& word) {
+            skipSpaces();
+            if (_pos + word.size() > _str.size()) return false;
+            for (size_t i = 0; i < word.size(); i++) {
+                if (toupper(static_cast<unsigned char>(_str[_pos + i])) != word[i]) return false;
+            }
+            size_t end = _pos + word.size();
+            if (end < _str.size() && (isalnum(static_cast<unsigned char>(_str[end])) || _str[end] == '_')) return false;
+            _pos = end;
+            return true;
+        }
+        
+        double expression(void) {
+            double value = term();
+            while (_error.empty()) {
+                if (accept("+")) value += term();
+                else if (accept("-")) value -= term();
+                else break;
+            }
+            return value;
+        }
+        
+        double term(void) {
+            double value = unary();
+            while (_error.empty()) {
+                if (accept("*")) {
+                    value *= unary();
+                } else if (accept("/")) {
+                    double divisor = unary();
+                    if (divisor == 0) _error = "division by zero";
+                    else value /= divisor;
+                } else if (accept("%") || acceptWord("MOD")) {
+                    double b = unary();
+                    if (b == 0) _error = "division by zero";
+                    else value = fmod(value, b) < 0 ? b + fmod(value, b) : fmod(value, b);
+                } else {
+                    break;
+                }
+            }
+            return value;
+        }
+        
+        double unary(void) {
+            if (accept("-")) return -unary();
+            if (accept("+")) return unary();
+            return power();
+        }
+        
+        double power(void) {
+            double base = primary();
+            if (accept("^")) return pow(base, unary());
+            return base;
+        }
+        
+        double primary(void) {
+            skipSpaces();
+            if (accept("(")) {
+                double value = expression();
+                if (!accept(")")) _error = "missing ')'";
+                return value;
+            }
+            if (accept("π")) return M_PI;
+            
+            if (_pos < _str.size() && (isdigit(static_cast<unsigned char>(_str[_pos])) || _str[_pos] == '.')) {
+                size_t length = 0;
+                double value = 0;
+                try {
+                    value = std::stod(_str.substr(_pos), &length);
+                } catch (...) {
+                    _error = "invalid number";
+                }
+                _pos += std::max<size_t>(length, 1);
+                return value;
+            }
+            
+            if (_pos < _str.size() && (isalpha(static_cast<unsigned char>(_str[_pos])) || _str[_pos] == '_')) {
+                size_t start = _pos;
+                while (_pos < _str.size() && (isalnum(static_cast<unsigned char>(_str[_pos])) || _str[_pos] == '_')) _pos++;
+                std::string name = _str.substr(start, _pos - start);
+                
+                auto it = _variables.find(name);
+                if (it != _variables.end()) return it->second;
+                
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                if (name == "pi") return M_PI;
+                if (name == "e" && !accept("(")) return M_E;
+                
+                std::vector<double> args;
+                if (!accept("(")) {
+                    _error = "unknown '" + _str.substr(start, _pos - start) + "'";
+                    return 0;
+                }
+                if (!accept(")")) {
+                    do {
+                        args.push_back(expression());
+                    } while (_error.empty() && accept(","));
+                    if (!accept(")")) _error = "missing ')'";
+                }
+                return call(name, args);
+            }
+            
+            _error = _pos < _str.size() ? "unexpected '" + _str.substr(_pos, 1) + "'" : "missing value";
+            return 0;
+        }
+        
+        // Drops the residue π leaves behind, so sin(180) in degrees is 0 as on the calculator.
+        static double snap(double value) {
+            return fabs(value) < 1e-15 ? 0 : value;
+        }
+        
+        double call(const std::string& name, const std::vector<double>& args) {
+            double angle = _degrees ? M_PI / 180 : 1;
+            
+            if (args.size() == 1) {
+                double x = args[0];
+                if (name == "sin") return snap(sin(x * angle));
+                if (name == "cos") return snap(cos(x * angle));
+                if (name == "tan") return snap(tan(x * angle));
+                if (name == "asin") return asin(x) / angle;
+                if (name == "acos") return acos(x) / angle;
+                if (name == "atan") return atan(x) / angle;
+                if (name == "sinh") return sinh(x);
+                if (name == "cosh") return cosh(x);
+                if (name == "tanh") return tanh(x);
+                if (name == "sqrt") return sqrt(x);
+                if (name == "abs") return fabs(x);
+                if (name == "floor") return floor(x);
+                if (name == "ceiling" || name == "ceil") return ceil(x);
+                if (name == "round") return round(x);
+                if (name == "ip") return trunc(x);
+                if (name == "fp") return x - trunc(x);
+                if (name == "sign") return (x > 0) - (x < 0);
+                if (name == "exp") return exp(x);
+                if (name == "ln") return log(x);
+                if (name == "log") return log10(x);
+            }
+            if (args.size() == 2) {
+                if (name == "min") return std::min(args[0], args[1]);
+                if (name == "max") return std::max(args[0], args[1]);
+                if (name == "atan2") return atan2(args[0], args[1]) / angle;
+                if (name == "round") return round(args[0] * pow(10, args[1])) / pow(10, args[1]);
+            }
+            
+            _error = "unknown function '" + name + "' taking " + std::to_string(args.size()) + " argument(s)";
+            return 0;
+        }
+    };
+}
+
 // MARK: - Public Methods
 
 std::string Calc::evaluateMathExpression(const std::string& str) {
@@ -425,6 +616,11 @@ std::string Calc::parse(const std::string& str) {
     return str;
 }
 
-
-
-
+bool Calc::evaluate(const std::string& expression, const std::unordered_map<std::string, double>& variables,
+                    double& result, bool degrees) {
+    std::string str = expression;
+    convertPPLStyleNumbersToBase10(str);
+    
+    Evaluator evaluator(str, variables, degrees);
+    return evaluator.evaluate(result);
+}
@@ -35,6 +35,14 @@ namespace pplplus {
     public:
         static std::string evaluateMathExpression(const std::string& str);
         static std::string parse(const std::string& str);
+        
+        /*
+         Evaluates an expression that may also use the given variables and functions such
+         as sin, sqrt or max, with angles in degrees rather than radians if degrees is set.
+         Returns false, having reported why, if the expression is not valid.
+         */
+        static bool evaluate(const std::string& expression, const std::unordered_map<std::string, double>& variables,
+                             double& result, bool degrees = false);
     };
 }
 
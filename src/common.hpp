@@ -38,6 +38,8 @@
 
 //#define basename(path)  path.string().substr(path.string().find_last_of("/") + 1)
 
+// The HP Prime allows up to 10,000 elements in a list.
+#define LIST_LIMIT 10000
 
 
 enum class MessageType {
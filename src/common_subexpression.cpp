@@ -0,0 +1,360 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_subexpression.hpp"
+#include "lexer.hpp"
+
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <map>
+
+using pplplus::CommonSubexpressionEliminator;
+using pplplus::Lexer;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 16
+#define MIN_TOKENS 4
+
+typedef struct TStatement {
+    size_t first;
+    size_t last;
+} TStatement;
+
+// An expression within a statement, by its first and last token.
+typedef struct TOccurrence {
+    size_t statement;
+    size_t first;
+    size_t last;
+} TOccurrence;
+
+// Keywords that begin or end a block, and so the run of statements that can share an expression.
+static bool isBoundary(const TToken& token) {
+    if (token.type != Type::Identifier) return false;
+    return Lexer::isBlockStart(token) || token.text == "REPEAT" || token.text == "END" || token.text == "ELSE" ||
+    token.text == "THEN" || token.text == "UNTIL" || token.text == "DEFAULT" || token.text == "DO";
+}
+
+// Locals and parameters of the function.
+static std::unordered_set<std::string> locals(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    std::unordered_set<std::string> names;
+    for (size_t i = function.params + 1; i < function.begin && !Lexer::isOperator(tokens[i], ")"); i++) {
+        if (tokens[i].type == Type::Identifier) names.insert(tokens[i].text);
+    }
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isStatementStart(tokens, i)) continue;
+        size_t end = Lexer::statementEnd(tokens, i);
+        int depth = 0;
+        bool declarator = true;
+        for (size_t j = i + 1; j <= end && j < function.end; j++) {
+            const TToken& token = tokens[j];
+            if (token.type == Type::Operator) {
+                if (Lexer::isOpening(token)) depth++;
+                if (Lexer::isClosing(token)) depth--;
+                if (depth == 0 && token.text == ",") declarator = true;
+                continue;
+            }
+            if (declarator && depth == 0 && token.type == Type::Identifier) names.insert(token.text);
+            declarator = false;
+        }
+        i = end;
+    }
+    return names;
+}
+
+/*
+ True if tokens first to last only use locals, numbers, strings and built-ins with no
+ side effects, adding the locals used to names.
+ */
+static bool isPure(const std::vector<TToken>& tokens, size_t first, size_t last,
+                   const std::unordered_set<std::string>& locals, std::unordered_set<std::string>& names) {
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Number || token.type == Type::String) continue;
+        if (token.type == Type::Operator) {
+            if (token.text == ":=" || token.text == "▶" || token.text == "." || token.text == ";") return false;
+            continue;
+        }
+        if (size_t name = Lexer::pureCall(tokens, i); name && i + name <= last) {
+            i += name - 1;
+            continue;
+        }
+        if (token.type != Type::Identifier) return false;
+        if (token.text == "AND" || token.text == "OR" || token.text == "NOT" || token.text == "XOR" ||
+            token.text == "MOD" || token.text == "DIV" || token.text == "π") continue;
+        if (!locals.contains(token.text)) return false;
+        names.insert(token.text);
+    }
+    return true;
+}
+
+// Variables the statement assigns to, including any named in a string that may be run by EXPR.
+static std::unordered_set<std::string> writes(const std::vector<TToken>& tokens, const TStatement& statement) {
+    std::unordered_set<std::string> names;
+    bool declaration = Lexer::isIdentifier(tokens[statement.first], "LOCAL");
+    
+    for (size_t i = statement.first; i <= statement.last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::String || token.type == Type::Directive) {
+            for (std::string_view word : Lexer::words(token.text)) names.insert(std::string(word));
+            continue;
+        }
+        if (token.type != Type::Identifier) continue;
+        if (declaration) {
+            names.insert(token.text);
+            continue;
+        }
+        
+        size_t next = i + 1;
+        while (next <= statement.last && Lexer::isOperator(tokens[next], "(")) next = Lexer::closing(tokens, next, statement.last + 1) + 1;
+        if ((next <= statement.last && Lexer::isOperator(tokens[next], ":=")) || (i > 0 && Lexer::isOperator(tokens[i - 1], "▶"))) {
+            names.insert(token.text);
+        }
+    }
+    return names;
+}
+
+/*
+ A statement in which an expression could be evaluated after an assignment made by the
+ same statement offers no expressions, so that the order of the two never matters.
+ */
+static bool isSimple(const std::vector<TToken>& tokens, const TStatement& statement) {
+    size_t assignments = 0;
+    int depth = 0;
+    for (size_t i = statement.first; i <= statement.last; i++) {
+        if (Lexer::isOpening(tokens[i])) depth++;
+        if (Lexer::isClosing(tokens[i])) depth--;
+        if (Lexer::isOperator(tokens[i], "▶")) return false;
+        if (Lexer::isOperator(tokens[i], ":=") && (depth || ++assignments > 1)) return false;
+    }
+    return true;
+}
+
+// A target of an assignment rather than an expression.
+static bool isTarget(const std::vector<TToken>& tokens, size_t first, size_t last, const TStatement& statement) {
+    return (last < statement.last && Lexer::isOperator(tokens[last + 1], ":=")) ||
+    (first > statement.first && Lexer::isOperator(tokens[first - 1], "▶"));
+}
+
+/*
+ The expressions of a statement that may be shared: the whole expressions between
+ commas, brackets and :=, and each call or list lookup.
+ */
+static std::vector<std::pair<size_t, size_t>> expressions(const std::vector<TToken>& tokens, const TStatement& statement,
+                                                          const std::unordered_set<std::string>& locals) {
+    std::vector<std::pair<size_t, size_t>> spans;
+    auto add = [&](size_t first, size_t last) {
+        if (first > last || last - first + 1 < MIN_TOKENS || isTarget(tokens, first, last, statement)) return;
+        if (first == statement.first) return;
+        spans.push_back({first, last});
+    };
+    
+    std::vector<size_t> starts = {statement.first};
+    for (size_t i = statement.first; i <= statement.last; i++) {
+        const TToken& token = tokens[i];
+        if (i == statement.first && (Lexer::isIdentifier(token, "RETURN") || Lexer::isIdentifier(token, "LOCAL"))) {
+            starts.back() = i + 1;
+            continue;
+        }
+        if (Lexer::isOpening(token)) {
+            starts.push_back(i + 1);
+            continue;
+        }
+        if (Lexer::isClosing(token)) {
+            if (starts.size() < 2) return spans;
+            add(starts.back(), i - 1);
+            starts.pop_back();
+            continue;
+        }
+        if (Lexer::isOperator(token, ",") || Lexer::isOperator(token, ":=") || Lexer::isOperator(token, ";") || Lexer::isOperator(token, "▶")) {
+            add(starts.back(), i - 1);
+            starts.back() = i + 1;
+        }
+    }
+    if (!Lexer::isOperator(tokens[statement.last], ";") && starts.size() == 1) add(starts.back(), statement.last);
+    
+    for (size_t i = statement.first; i < statement.last; i++) {
+        size_t name = Lexer::pureCall(tokens, i);
+        bool lookup = !name && tokens[i].type == Type::Identifier && locals.contains(tokens[i].text) &&
+        Lexer::isOperator(tokens[i + 1], "(") && (i == statement.first || !Lexer::isOperator(tokens[i - 1], "."));
+        if (!name && !lookup) continue;
+        
+        // L(i) and L(i)(2)
+        size_t close = Lexer::closing(tokens, i + std::max<size_t>(name, 1), statement.last + 1);
+        while (close < statement.last) {
+            add(i, close);
+            if (!lookup || !Lexer::isOperator(tokens[close + 1], "(")) break;
+            close = Lexer::closing(tokens, close + 1, statement.last + 1);
+        }
+    }
+    
+    std::sort(spans.begin(), spans.end());
+    spans.erase(std::unique(spans.begin(), spans.end()), spans.end());
+    return spans;
+}
+
+static std::string key(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    std::string text;
+    for (size_t i = first; i <= last; i++) text += tokens[i].text + " ";
+    return text;
+}
+
+static std::string indentation(std::string_view code, size_t offset) {
+    size_t start = code.rfind('\n', offset);
+    start = start == std::string_view::npos ? 0 : start + 1;
+    size_t end = start;
+    while (end < offset && (code[end] == ' ' || code[end] == '\t')) end++;
+    return std::string(code.substr(start, end - start));
+}
+
+// MARK: - Runs
+
+/*
+ Groups of the same expression in a run of statements, each ended by an assignment to
+ one of the variables it uses.
+ */
+static std::vector<std::vector<TOccurrence>> repeats(const std::vector<TToken>& tokens, const std::vector<TStatement>& run,
+                                                     const std::unordered_set<std::string>& locals) {
+    std::vector<std::vector<TOccurrence>> groups;
+    std::map<std::string, std::vector<TOccurrence>> open;
+    std::unordered_map<std::string, std::unordered_set<std::string>> uses;
+    
+    for (size_t n = 0; n < run.size(); n++) {
+        const TStatement& statement = run[n];
+        if (isSimple(tokens, statement)) {
+            for (const auto& [first, last] : expressions(tokens, statement, locals)) {
+                std::unordered_set<std::string> names;
+                if (!isPure(tokens, first, last, locals, names)) continue;
+                std::string text = key(tokens, first, last);
+                open[text].push_back({n, first, last});
+                uses[text] = names;
+            }
+        }
+        
+        std::unordered_set<std::string> changed = writes(tokens, statement);
+        for (auto it = open.begin(); it != open.end();) {
+            bool stale = false;
+            for (const std::string& name : uses[it->first]) stale = stale || changed.contains(name);
+            if (!stale) {
+                it++;
+                continue;
+            }
+            if (it->second.size() > 1) groups.push_back(it->second);
+            it = open.erase(it);
+        }
+    }
+    for (const auto& [text, occurrences] : open) {
+        if (occurrences.size() > 1) groups.push_back(occurrences);
+    }
+    
+    // The longest first, so L(i)(2) is shared rather than the L(i) within it.
+    std::stable_sort(groups.begin(), groups.end(), [](const auto& a, const auto& b) {
+        return a.front().last - a.front().first > b.front().last - b.front().first;
+    });
+    return groups;
+}
+
+static void share(std::string_view code, const std::vector<TToken>& tokens, const std::vector<TStatement>& run,
+                  const std::unordered_set<std::string>& locals, std::unordered_set<std::string>& used,
+                  Edits& edits, CommonSubexpressionEliminator::TReport& report) {
+    std::vector<std::pair<size_t, size_t>> taken;
+    std::map<size_t, std::string> declarations;
+    
+    for (const std::vector<TOccurrence>& group : repeats(tokens, run, locals)) {
+        std::vector<TOccurrence> free;
+        for (const TOccurrence& occurrence : group) {
+            bool overlaps = false;
+            for (const auto& [first, last] : taken) {
+                overlaps = overlaps || (occurrence.first <= last && first <= occurrence.last);
+            }
+            if (!overlaps) free.push_back(occurrence);
+        }
+        if (free.size() < 2) continue;
+        
+        std::string name = Lexer::fresh("cse", used);
+        for (const TOccurrence& occurrence : free) {
+            size_t start = tokens[occurrence.first].offset;
+            edits.add({start, tokens[occurrence.last].offset + tokens[occurrence.last].text.size() - start, name});
+            taken.push_back({occurrence.first, occurrence.last});
+        }
+        
+        std::string& text = declarations[free.front().statement];
+        text += (text.empty() ? "LOCAL " : ", ") + name + " := " + std::string(Lexer::text(code, tokens, free.front().first, free.front().last));
+        report.temporaries++;
+        report.replaced += free.size();
+    }
+    
+    for (const auto& [n, text] : declarations) {
+        size_t start = tokens[run[n].first].offset;
+        edits.add({start, 0, text + ";\n" + indentation(code, start)});
+    }
+}
+
+// MARK: - Public Methods
+
+std::string CommonSubexpressionEliminator::eliminate(const std::string& code) {
+    _report = TReport();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        
+        std::unordered_set<std::string> used;
+        for (const TToken& token : tokens) {
+            if (token.type == Type::Identifier) used.insert(token.text);
+            if (token.type == Type::String || token.type == Type::Directive) {
+                for (std::string_view word : Lexer::words(token.text)) used.insert(std::string(word));
+            }
+        }
+        
+        Edits edits;
+        for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+            if (function.end >= tokens.size()) continue;
+            std::unordered_set<std::string> names = locals(tokens, function);
+            
+            std::vector<TStatement> run;
+            for (size_t i = function.begin + 1; i < function.end; i++) {
+                if (isBoundary(tokens[i])) {
+                    share(result, tokens, run, names, used, edits, _report);
+                    run.clear();
+                    continue;
+                }
+                if (!Lexer::isStatementStart(tokens, i)) continue;
+                
+                size_t last = std::min(Lexer::statementEnd(tokens, i), function.end - 1);
+                run.push_back({i, last});
+                i = last;
+            }
+            share(result, tokens, run, names, used, edits, _report);
+        }
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
@@ -0,0 +1,60 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef COMMON_SUBEXPRESSION_HPP
+#define COMMON_SUBEXPRESSION_HPP
+
+#include <string>
+
+namespace pplplus {
+    /*
+     Finds an expression written more than once in a run of statements, such as
+     L(i)(2), x*320+y or B→R(c) repeated by a macro, and evaluates it once into a new
+     local that the repeats then read.
+     
+     An expression qualifies if it only uses locals, parameters, numbers and built-ins
+     with no side effects. A called function cannot change the locals of its caller, so
+     only an assignment to one of its variables ends the run in which it can be reused.
+     Whole expressions, such as an argument or the value assigned, are matched, as are
+     list lookups and calls, so that the new local never changes the precedence.
+     */
+    class CommonSubexpressionEliminator {
+    public:
+        typedef struct TReport {
+            size_t temporaries = 0;
+            size_t replaced = 0;
+        } TReport;
+        
+        std::string eliminate(const std::string& code);
+        
+        const TReport& report(void) const {
+            return _report;
+        }
+        
+    private:
+        TReport _report;
+    };
+}
+
+#endif // COMMON_SUBEXPRESSION_HPP
@@ -0,0 +1,388 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "constant_folder.hpp"
+#include "lexer.hpp"
+#include "expression.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+using pplplus::ConstantFolder;
+using pplplus::Lexer;
+using pplplus::Expression;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 16
+#define MAX_RUN 64
+
+// MARK: - Tokens
+
+static bool isOperatorKeyword(const TToken& token) {
+    return token.type == Type::Identifier &&
+    (token.text == "AND" || token.text == "OR" || token.text == "XOR" || token.text == "NOT" || token.text == "MOD");
+}
+
+static bool isPi(const TToken& token) {
+    return Lexer::is(token, Type::Identifier, "π");
+}
+
+// Precedence of the operator at index i, higher binds tighter, or 0 if it is not an operator.
+static int precedence(const std::vector<TToken>& tokens, size_t i) {
+    const TToken& token = tokens[i];
+    const std::string& op = token.text;
+    if (token.type != Type::Operator && !isOperatorKeyword(token)) return 0;
+    
+    if (i == 0 || !Lexer::isOperand(tokens[i - 1])) {
+        if (op == "-" || op == "+") return 7;
+        if (op == "NOT") return 3;
+        return 0;
+    }
+    
+    if (op == "OR" || op == "XOR") return 1;
+    if (op == "AND") return 2;
+    if (op == "==" || op == "=" || op == "≠" || op == "<>" || op == "!=" ||
+        op == "<" || op == ">" || op == "≤" || op == "<=" || op == "≥" || op == ">=") return 4;
+    if (op == "+" || op == "-") return 5;
+    if (op == "*" || op == "/" || op == "MOD") return 6;
+    if (op == "^") return 8;
+    return 0;
+}
+
+// Tokens that end an expression, so that nothing beyond them binds to it.
+static bool isBoundary(const TToken& token) {
+    if (token.type == Type::Directive) return true;
+    if (token.type == Type::Identifier) return Lexer::isKeyword(token.text) && !isOperatorKeyword(token);
+    if (token.type != Type::Operator) return false;
+    
+    const std::string& op = token.text;
+    return op == "(" || op == "[" || op == "{" || op == ")" || op == "]" || op == "}" ||
+    op == "," || op == ";" || op == ":=" || op == "▶";
+}
+
+// Lowest precedence among the operators of tokens first to last outside of parentheses.
+static int lowestPrecedence(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    int lowest = 99;
+    int depth = 0;
+    for (size_t i = first; i <= last; i++) {
+        if (Lexer::isOpening(tokens[i])) depth++;
+        else if (Lexer::isClosing(tokens[i])) depth--;
+        else if (depth == 0 && precedence(tokens, i)) lowest = std::min(lowest, precedence(tokens, i));
+    }
+    return lowest;
+}
+
+// MARK: - Numbers
+
+static std::string formatReal(double value) {
+    if (value == std::floor(value) && std::fabs(value) < 1e12) {
+        return std::to_string(static_cast<long long>(value));
+    }
+    
+    std::ostringstream os;
+    os << std::setprecision(12) << value;
+    std::string text = os.str();
+    
+    size_t e = text.find('e');
+    if (e != std::string::npos) {
+        std::string exponent = text.substr(e + 1);
+        bool negative = exponent.front() == '-';
+        exponent.erase(0, exponent.find_first_not_of("+-0"));
+        text = text.substr(0, e) + "ᴇ" + (negative ? "-" : "") + exponent;
+    }
+    return text;
+}
+
+/*
+ The result as an integer in the base and width of the first integer such as #FF:32h
+ in tokens first to last. False if the expression mixes in anything that would not
+ give the same integer result on the calculator.
+ */
+static bool formatInteger(const std::vector<TToken>& tokens, size_t first, size_t last, double value, std::string& text) {
+    const TToken* integer = nullptr;
+    
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Number) {
+            if (token.text.front() == '#') {
+                if (token.text.find(":-") != std::string::npos) return false;
+                if (!integer) integer = &token;
+                continue;
+            }
+            double n;
+            if (!Expression::number(token.text, n) || n != std::floor(n)) return false;
+            continue;
+        }
+        if (token.type == Type::Operator && (token.text == "+" || token.text == "-" || token.text == "*" || Lexer::isOpening(token) || Lexer::isClosing(token))) continue;
+        return false;
+    }
+    if (!integer) return false;
+    
+    const std::string& literal = integer->text;
+    size_t colon = literal.find(':');
+    int bits = colon == std::string::npos ? 64 : std::atoi(literal.c_str() + colon + 1);
+    double limit = std::ldexp(1.0, std::min(bits, 53));
+    if (value < 0 || value >= limit || value != std::floor(value)) return false;
+    
+    int base = 10;
+    switch (literal.back()) {
+        case 'h': base = 16; break;
+        case 'o': base = 8; break;
+        case 'b': base = 2; break;
+    }
+    
+    uint64_t n = static_cast<uint64_t>(value);
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), "0123456789ABCDEF"[n % base]);
+        n /= base;
+    } while (n);
+    
+    text = "#" + digits;
+    if (colon != std::string::npos) text += literal.substr(colon, literal.size() - 1 - colon);
+    text += literal.back();
+    return true;
+}
+
+static std::string compact(std::string_view text) {
+    std::string result;
+    for (char c : text) {
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') result += c;
+    }
+    return result;
+}
+
+// MARK: - Folding
+
+static void foldExpressions(std::string_view code, const std::vector<TToken>& tokens, Edits& edits, size_t& count) {
+    for (size_t first = 0; first < tokens.size(); first++) {
+        const TToken& token = tokens[first];
+        bool leading = first == 0 || !Lexer::isOperand(tokens[first - 1]);
+        if (!leading) continue;
+        
+        bool unary = token.text == "-" || token.text == "+" || Lexer::is(token, Type::Identifier, "NOT");
+        if (token.type != Type::Number && !isPi(token) && !Lexer::is(token, Type::Operator, "(") && !unary) continue;
+        
+        // Every constant expression starting here, longest last.
+        std::vector<std::pair<size_t, double>> candidates;
+        for (size_t last = first; last < tokens.size() && last < first + MAX_RUN; last++) {
+            const TToken& next = tokens[last];
+            if (next.type == Type::String || next.type == Type::Directive) break;
+            if (next.type == Type::Identifier && !isPi(next) && !isOperatorKeyword(next)) break;
+            if (Lexer::is(next, Type::Operator, ";") || Lexer::is(next, Type::Operator, ",") || Lexer::is(next, Type::Operator, ":=")) break;
+            
+            double value;
+            if (Expression::evaluate(tokens, first, last, value) && std::isfinite(value)) candidates.push_back({last, value});
+        }
+        
+        for (auto it = candidates.rbegin(); it != candidates.rend(); it++) {
+            auto [last, value] = *it;
+            
+            size_t atoms = 0;
+            for (size_t i = first; i <= last; i++) {
+                if (tokens[i].type == Type::Number || isPi(tokens[i])) atoms++;
+            }
+            if (atoms < 2) continue;
+            
+            // Nothing around the expression may bind to part of it more tightly than the whole.
+            int lowest = lowestPrecedence(tokens, first, last);
+            if (first > 0 && !isBoundary(tokens[first - 1])) {
+                int left = precedence(tokens, first - 1);
+                if (!left || left >= lowest) continue;
+            }
+            if (last + 1 < tokens.size() && !isBoundary(tokens[last + 1])) {
+                int right = precedence(tokens, last + 1);
+                if (!right || right > lowest || (right == lowest && tokens[last + 1].text == "^")) continue;
+            }
+            
+            std::string text;
+            bool integer = false;
+            for (size_t i = first; i <= last; i++) {
+                if (tokens[i].type == Type::Number && tokens[i].text.front() == '#') integer = true;
+            }
+            if (integer && !formatInteger(tokens, first, last, value, text)) continue;
+            if (!integer) text = formatReal(value);
+            if (value < 0 && first > 0 && !isBoundary(tokens[first - 1])) text = "(" + text + ")";
+            
+            std::string_view original = Lexer::text(code, tokens, first, last);
+            if (compact(original) == text) break;
+            
+            if (edits.add({tokens[first].offset, original.size(), text})) {
+                count++;
+                first = last;
+            }
+            break;
+        }
+    }
+}
+
+// MARK: - Propagation
+
+typedef struct TConstant {
+    std::string text;
+    size_t declaration;
+} TConstant;
+
+// The number in `name := number` or `name := -number` at index i, ending with , or ;
+static bool literalValue(const std::vector<TToken>& tokens, size_t i, std::string& text) {
+    if (i + 3 >= tokens.size() || !Lexer::is(tokens[i + 1], Type::Operator, ":=")) return false;
+    
+    size_t n = i + 2;
+    bool negative = Lexer::is(tokens[n], Type::Operator, "-");
+    if (negative) n++;
+    if (n + 1 >= tokens.size() || tokens[n].type != Type::Number) return false;
+    if (!Lexer::is(tokens[n + 1], Type::Operator, ",") && !Lexer::is(tokens[n + 1], Type::Operator, ";")) return false;
+    
+    text = (negative ? "-" : "") + tokens[n].text;
+    return true;
+}
+
+static bool isDeclaration(const TToken& token) {
+    return Lexer::is(token, Type::Identifier, "LOCAL") || Lexer::is(token, Type::Identifier, "CONST");
+}
+
+// Names declared by the LOCAL or CONST statement at index i, and the index of each.
+static std::vector<size_t> declarators(const std::vector<TToken>& tokens, size_t i) {
+    std::vector<size_t> names;
+    size_t last = Lexer::statementEnd(tokens, i);
+    bool expectName = true;
+    int depth = 0;
+    
+    for (size_t j = i + 1; j <= last && j < tokens.size(); j++) {
+        if (Lexer::isOpening(tokens[j])) depth++;
+        if (Lexer::isClosing(tokens[j])) depth--;
+        if (expectName && tokens[j].type == Type::Identifier) names.push_back(j);
+        expectName = depth == 0 && Lexer::is(tokens[j], Type::Operator, ",");
+    }
+    return names;
+}
+
+static void propagateConstants(const std::vector<TToken>& tokens, Edits& edits, size_t& count) {
+    std::vector<Lexer::TFunction> functions = Lexer::functions(tokens);
+    
+    // CONST declared outside of any function applies to every function that does not declare the name itself.
+    std::unordered_map<std::string, std::string> globals;
+    size_t next = 0;
+    for (const Lexer::TFunction& function : functions) {
+        for (size_t i = next; i < function.start; i++) {
+            if (!Lexer::is(tokens[i], Type::Identifier, "CONST")) continue;
+            for (size_t name : declarators(tokens, i)) {
+                std::string text;
+                if (literalValue(tokens, name, text)) globals[tokens[name].text] = text;
+            }
+        }
+        next = function.end + 1;
+    }
+    
+    for (const Lexer::TFunction& function : functions) {
+        if (function.end >= tokens.size()) continue;
+        
+        std::unordered_map<std::string, size_t> declared;
+        std::unordered_map<std::string, TConstant> constants;
+        std::unordered_set<size_t> declaratorIndices;
+        
+        for (size_t i = function.params; i < function.begin; i++) {
+            if (tokens[i].type == Type::Identifier) declared[tokens[i].text]++;
+        }
+        for (size_t i = function.begin + 1; i < function.end; i++) {
+            if (!isDeclaration(tokens[i])) continue;
+            for (size_t name : declarators(tokens, i)) {
+                declared[tokens[name].text]++;
+                declaratorIndices.insert(name);
+                std::string text;
+                if (literalValue(tokens, name, text)) constants[tokens[name].text] = {text, name};
+            }
+        }
+        for (auto it = constants.begin(); it != constants.end();) {
+            it = declared[it->first] == 1 ? std::next(it) : constants.erase(it);
+        }
+        for (const auto& [name, text] : globals) {
+            if (!declared.contains(name)) constants[name] = {text, function.begin};
+        }
+        if (constants.empty()) continue;
+        
+        // Reads of each constant, or none at all if it is ever written or used in a way that is not a plain read.
+        std::unordered_map<std::string, std::vector<size_t>> reads;
+        std::unordered_set<std::string> blocked;
+        
+        for (size_t i = function.begin + 1; i < function.end; i++) {
+            const TToken& token = tokens[i];
+            if (token.type == Type::String || token.type == Type::Directive) {
+                for (std::string_view word : Lexer::words(token.text)) blocked.insert(std::string(word));
+                continue;
+            }
+            if (token.type != Type::Identifier || declaratorIndices.contains(i)) continue;
+            
+            auto it = constants.find(token.text);
+            if (it == constants.end()) continue;
+            if (Lexer::is(tokens[i - 1], Type::Operator, ".")) continue;
+            
+            bool written = Lexer::is(tokens[i + 1], Type::Operator, ":=") || Lexer::is(tokens[i - 1], Type::Operator, "▶") ||
+            Lexer::is(tokens[i - 1], Type::Identifier, "FOR");
+            bool indexed = Lexer::is(tokens[i + 1], Type::Operator, "(") || Lexer::is(tokens[i + 1], Type::Operator, "[");
+            if (written || indexed || i < it->second.declaration) {
+                blocked.insert(token.text);
+                continue;
+            }
+            reads[token.text].push_back(i);
+        }
+        
+        for (const auto& [name, indices] : reads) {
+            if (blocked.contains(name)) continue;
+            const std::string& value = constants[name].text;
+            
+            for (size_t i : indices) {
+                std::string text = value;
+                if (value.front() == '-' && !isBoundary(tokens[i - 1])) text = "(" + value + ")";
+                if (edits.add({tokens[i].offset, tokens[i].text.size(), text})) count++;
+            }
+        }
+    }
+}
+
+// MARK: - Public Methods
+
+std::string ConstantFolder::fold(const std::string& code) {
+    _report = TReport();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        Edits edits;
+        
+        foldExpressions(result, tokens, edits, _report.folded);
+        propagateConstants(tokens, edits, _report.propagated);
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
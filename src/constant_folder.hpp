@@ -0,0 +1,63 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CONSTANT_FOLDER_HPP
+#define CONSTANT_FOLDER_HPP
+
+#include <string>
+
+namespace pplplus {
+    /*
+     Evaluates constant sub-expressions in the generated PPL, so the calculator does not
+     evaluate them again each time they run, for example 2*π/360, #FF:32h+1 or the
+     arithmetic left by expanded #define constants.
+     
+     Locals, and constants declared with CONST, whose value is a number and which are
+     never assigned again are replaced by that number where they are read. The number
+     may in turn fold with its neighbours, so folding and propagation are repeated until
+     nothing more changes. The declarations are left for --dce to remove.
+     
+     Real results are written with the 12 significant digits the HP Prime calculates
+     with. Integers such as #FFh only fold with +, - and *, and keep the base and width
+     of the first one in the expression.
+     */
+    class ConstantFolder {
+    public:
+        typedef struct TReport {
+            size_t folded = 0;
+            size_t propagated = 0;
+        } TReport;
+        
+        std::string fold(const std::string& code);
+        
+        const TReport& report(void) const {
+            return _report;
+        }
+        
+    private:
+        TReport _report;
+    };
+}
+
+#endif // CONSTANT_FOLDER_HPP
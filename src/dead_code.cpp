@@ -0,0 +1,317 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "dead_code.hpp"
+#include "lexer.hpp"
+#include "expression.hpp"
+
+#include <unordered_set>
+#include <unordered_map>
+
+using pplplus::DeadCodeEliminator;
+using pplplus::Lexer;
+using pplplus::Expression;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 16
+
+// A variable in a LOCAL statement: the name, and the last token of its initializer if it has one.
+typedef struct TDeclarator {
+    size_t name;
+    size_t last;
+} TDeclarator;
+
+typedef struct TLocalStatement {
+    size_t first;
+    size_t last;
+    std::vector<TDeclarator> declarators;
+} TLocalStatement;
+
+// Tokens that end the statements of a block.
+static bool isTerminator(const TToken& token) {
+    return Lexer::isIdentifier(token, "END") || Lexer::isIdentifier(token, "ELSE") || Lexer::isIdentifier(token, "UNTIL") ||
+    Lexer::isIdentifier(token, "THEN") || Lexer::isIdentifier(token, "DEFAULT");
+}
+
+/*
+ True if evaluating tokens first to last can have no effect besides its value. Only
+ numbers, strings, operators and the variables in names qualify, as anything else
+ may be a call to a function or to a built-in such as GETKEY or RANDOM.
+ */
+static bool isPure(const std::vector<TToken>& tokens, size_t first, size_t last, const std::unordered_set<std::string>& names) {
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Operator && (token.text == ":=" || token.text == "▶")) return false;
+        if (token.type != Type::Identifier || Lexer::isKeyword(token.text) || token.text == "π") continue;
+        if (!names.contains(token.text)) return false;
+    }
+    return true;
+}
+
+// MARK: - Rules
+
+// IF with a constant condition, replaced by the branch taken.
+static void constantBranches(std::string_view code, const std::vector<TToken>& tokens, const Lexer::TFunction& function,
+                             Edits& edits, DeadCodeEliminator::TReport& report) {
+    // The IF THEN ... END clauses of CASE blocks, which only make sense as clauses.
+    std::unordered_set<size_t> clauses;
+    for (size_t k = function.begin + 1; k < function.end; k++) {
+        if (!Lexer::isIdentifier(tokens[k], "CASE")) continue;
+        size_t end = Lexer::blockEnd(tokens, k);
+        for (size_t j = k + 1; j < end && !Lexer::isIdentifier(tokens[j], "DEFAULT"); j++) {
+            if (!Lexer::isIdentifier(tokens[j], "IF")) continue;
+            clauses.insert(j);
+            j = Lexer::blockEnd(tokens, j);
+        }
+    }
+    
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "IF")) continue;
+        
+        size_t then = i + 1;
+        while (then < function.end && !Lexer::isIdentifier(tokens[then], "THEN")) then++;
+        
+        double value;
+        if (then >= function.end || !Expression::evaluate(tokens, i + 1, then - 1, value)) continue;
+        
+        size_t end = Lexer::blockEnd(tokens, i);
+        if (end >= function.end) continue;
+        size_t last = end + 1 < tokens.size() && Lexer::is(tokens[end + 1], Type::Operator, ";") ? end + 1 : end;
+        
+        // A clause that is always taken has to stay a clause, one never taken can go.
+        if (clauses.contains(i)) {
+            if (value == 0 && edits.add(Lexer::erase(code, tokens, i, last))) {
+                report.branches++;
+                i = last;
+            }
+            continue;
+        }
+        
+        size_t otherwise = end;
+        for (size_t k = then + 1; k < end; k++) {
+            if (Lexer::isBlockStart(tokens[k])) {
+                k = Lexer::blockEnd(tokens, k);
+                continue;
+            }
+            if (Lexer::isIdentifier(tokens[k], "ELSE")) {
+                otherwise = k;
+                break;
+            }
+        }
+        
+        size_t first = value != 0 ? then + 1 : otherwise + 1;
+        size_t final = value != 0 ? otherwise - 1 : end - 1;
+        
+        Lexer::TEdit edit = Lexer::erase(code, tokens, i, last);
+        if (first <= final && first < end) {
+            size_t start = tokens[i].offset;
+            edit = {start, tokens[last].offset + tokens[last].text.size() - start, std::string(Lexer::text(code, tokens, first, final))};
+        }
+        if (edits.add(edit)) report.branches++;
+        i = last;
+    }
+}
+
+// Statements after a RETURN, up to the end of its block.
+static void unreachableCode(std::string_view code, const std::vector<TToken>& tokens, const Lexer::TFunction& function,
+                            Edits& edits, DeadCodeEliminator::TReport& report) {
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "RETURN") || !Lexer::isStatementStart(tokens, i)) continue;
+        
+        size_t first = Lexer::statementEnd(tokens, i) + 1;
+        size_t last = first;
+        size_t count = 0;
+        for (size_t j = first; j < function.end && !isTerminator(tokens[j]); j = last + 1) {
+            last = Lexer::statementEnd(tokens, j);
+            count++;
+        }
+        
+        if (count && edits.add(Lexer::erase(code, tokens, first, last))) report.unreachable += count;
+        i = first > i ? first - 1 : i;
+    }
+}
+
+static std::vector<TLocalStatement> localStatements(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    std::vector<TLocalStatement> statements;
+    
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isStatementStart(tokens, i)) continue;
+        
+        TLocalStatement statement;
+        statement.first = i;
+        statement.last = Lexer::statementEnd(tokens, i);
+        
+        // LOCAL a, b := expression, c;
+        size_t j = i + 1;
+        while (j < statement.last && tokens[j].type == Type::Identifier) {
+            TDeclarator declarator{j, j};
+            int depth = 0;
+            for (j++; j < statement.last; j++) {
+                const TToken& token = tokens[j];
+                if (token.type == Type::Operator) {
+                    if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+                    if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+                    if (depth == 0 && token.text == ",") break;
+                }
+                declarator.last = j;
+            }
+            statement.declarators.push_back(declarator);
+            j++;
+        }
+        
+        statements.push_back(statement);
+        i = statement.last;
+    }
+    
+    return statements;
+}
+
+// Assignments to locals that are never read, then the declarations of locals that are not used at all.
+static void unusedLocals(std::string_view code, const std::vector<TToken>& tokens, const Lexer::TFunction& function,
+                         Edits& edits, DeadCodeEliminator::TReport& report) {
+    std::vector<TLocalStatement> statements = localStatements(tokens, function);
+    if (statements.empty()) return;
+    
+    std::unordered_set<std::string> names;
+    std::unordered_map<std::string, size_t> declarations;
+    for (size_t i = function.params; i < function.begin; i++) {
+        if (tokens[i].type == Type::Identifier) names.insert(tokens[i].text);
+    }
+    for (const TLocalStatement& statement : statements) {
+        for (const TDeclarator& declarator : statement.declarators) {
+            names.insert(tokens[declarator.name].text);
+            declarations[tokens[declarator.name].text]++;
+        }
+    }
+    
+    // Uses of each local, besides its declaration and the assignments to it.
+    std::unordered_map<std::string, size_t> reads;
+    std::unordered_map<std::string, std::vector<size_t>> assignments;
+    std::unordered_set<size_t> declarators;
+    for (const TLocalStatement& statement : statements) {
+        for (const TDeclarator& declarator : statement.declarators) declarators.insert(declarator.name);
+    }
+    
+    // The assignment being scanned, where the local may be read in its own new value.
+    std::string_view target;
+    size_t targetEnd = 0;
+    
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::String || token.type == Type::Directive) {
+            for (std::string_view word : Lexer::words(token.text)) reads[std::string(word)]++;
+            continue;
+        }
+        if (token.type != Type::Identifier || !declarations.contains(token.text) || declarators.contains(i)) continue;
+        if (i > 0 && Lexer::is(tokens[i - 1], Type::Operator, ".")) continue;
+        
+        if (Lexer::isStatementStart(tokens, i) && i + 1 < function.end && Lexer::is(tokens[i + 1], Type::Operator, ":=")) {
+            assignments[token.text].push_back(i);
+            target = token.text;
+            targetEnd = Lexer::statementEnd(tokens, i);
+            continue;
+        }
+        if (token.text == target && i <= targetEnd) continue;
+        reads[token.text]++;
+    }
+    
+    std::unordered_set<std::string> unused;
+    for (const auto& [name, count] : declarations) {
+        if (count != 1 || reads[name]) continue;
+        
+        // Written but never read.
+        if (!assignments[name].empty()) {
+            for (size_t i : assignments[name]) {
+                size_t last = Lexer::statementEnd(tokens, i);
+                size_t end = Lexer::is(tokens[last], Type::Operator, ";") ? last - 1 : last;
+                
+                Lexer::TEdit edit;
+                if (isPure(tokens, i + 2, end, names)) {
+                    edit = Lexer::erase(code, tokens, i, last);
+                } else {
+                    edit = {tokens[i].offset, tokens[i + 2].offset - tokens[i].offset, ""};
+                }
+                if (edits.add(edit)) report.assignments++;
+            }
+            continue;
+        }
+        unused.insert(name);
+    }
+    
+    for (const TLocalStatement& statement : statements) {
+        std::vector<std::string_view> kept;
+        size_t removed = 0;
+        
+        for (const TDeclarator& declarator : statement.declarators) {
+            const std::string& name = tokens[declarator.name].text;
+            bool initialized = declarator.last > declarator.name + 1;
+            if (unused.contains(name) && (!initialized || isPure(tokens, declarator.name + 2, declarator.last, names))) {
+                removed++;
+                continue;
+            }
+            kept.push_back(Lexer::text(code, tokens, declarator.name, declarator.last));
+        }
+        if (!removed) continue;
+        
+        Lexer::TEdit edit = Lexer::erase(code, tokens, statement.first, statement.last);
+        if (!kept.empty()) {
+            std::string text = "LOCAL ";
+            for (size_t n = 0; n < kept.size(); n++) {
+                if (n) text += ", ";
+                text += kept[n];
+            }
+            text += ";";
+            size_t start = tokens[statement.first].offset;
+            edit = {start, tokens[statement.last].offset + tokens[statement.last].text.size() - start, text};
+        }
+        if (edits.add(edit)) report.locals += removed;
+    }
+}
+
+// MARK: - Public Methods
+
+std::string DeadCodeEliminator::eliminate(const std::string& code) {
+    _report = TReport();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        Edits edits;
+        
+        for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+            if (function.end >= tokens.size()) continue;
+            constantBranches(result, tokens, function, edits, _report);
+            unreachableCode(result, tokens, function, edits, _report);
+            unusedLocals(result, tokens, function, edits, _report);
+        }
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
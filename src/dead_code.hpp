@@ -0,0 +1,65 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DEAD_CODE_HPP
+#define DEAD_CODE_HPP
+
+#include <string>
+
+namespace pplplus {
+    /*
+     Removes code inside functions that can never run or whose result is never used.
+     
+     - IF statements whose condition is a constant, such as the IF 0 THEN ... END;
+       left by debug macros, are replaced by the branch that is taken.
+     - Statements that follow a RETURN in the same block are removed.
+     - Assignments to a LOCAL that is never read are removed, keeping the right-hand
+       side as a statement of its own if it may have side effects.
+     - LOCAL declarations that are no longer used are removed.
+     
+     The rules are applied until nothing more changes, as one removal often exposes
+     another.
+     */
+    class DeadCodeEliminator {
+    public:
+        typedef struct TReport {
+            size_t branches = 0;
+            size_t unreachable = 0;
+            size_t assignments = 0;
+            size_t locals = 0;
+        } TReport;
+        
+        std::string eliminate(const std::string& code);
+        
+        // What was removed by the last call to eliminate.
+        const TReport& report(void) const {
+            return _report;
+        }
+        
+    private:
+        TReport _report;
+    };
+}
+
+#endif // DEAD_CODE_HPP
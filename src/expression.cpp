@@ -0,0 +1,242 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "expression.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+
+using pplplus::Expression;
+using pplplus::Lexer;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+namespace {
+    // Recursive descent over the tokens, lowest precedence first.
+    class Parser {
+    public:
+        Parser(const std::vector<TToken>& tokens, size_t first, size_t last) : _tokens(tokens), _pos(first), _end(last + 1) {
+        }
+        
+        bool parse(double& value) {
+            return logical(value) && _pos == _end;
+        }
+        
+    private:
+        const std::vector<TToken>& _tokens;
+        size_t _pos;
+        size_t _end;
+        
+        bool accept(std::string_view text) {
+            if (_pos >= _end || _tokens[_pos].text != text || _tokens[_pos].type == Type::String) return false;
+            _pos++;
+            return true;
+        }
+        
+        bool logical(double& value) {
+            if (!conjunction(value)) return false;
+            while (true) {
+                bool isOr = accept("OR");
+                if (!isOr && !accept("XOR")) return true;
+                double rhs;
+                if (!conjunction(rhs)) return false;
+                value = isOr ? (value != 0 || rhs != 0) : ((value != 0) != (rhs != 0));
+            }
+        }
+        
+        bool conjunction(double& value) {
+            if (!negation(value)) return false;
+            while (accept("AND")) {
+                double rhs;
+                if (!negation(rhs)) return false;
+                value = value != 0 && rhs != 0;
+            }
+            return true;
+        }
+        
+        bool negation(double& value) {
+            if (accept("NOT")) {
+                if (!negation(value)) return false;
+                value = value == 0;
+                return true;
+            }
+            return comparison(value);
+        }
+        
+        bool comparison(double& value) {
+            if (!sum(value)) return false;
+            while (_pos < _end) {
+                std::string op = _tokens[_pos].text;
+                if (_tokens[_pos].type != Type::Operator) return true;
+                if (op != "==" && op != "=" && op != "≠" && op != "<>" && op != "!=" &&
+                    op != "<" && op != ">" && op != "≤" && op != "<=" && op != "≥" && op != ">=") return true;
+                _pos++;
+                
+                double rhs;
+                if (!sum(rhs)) return false;
+                if (op == "==" || op == "=") value = value == rhs;
+                else if (op == "<") value = value < rhs;
+                else if (op == ">") value = value > rhs;
+                else if (op == "≤" || op == "<=") value = value <= rhs;
+                else if (op == "≥" || op == ">=") value = value >= rhs;
+                else value = value != rhs;
+            }
+            return true;
+        }
+        
+        bool sum(double& value) {
+            if (!product(value)) return false;
+            while (true) {
+                bool add = accept("+");
+                if (!add && !accept("-")) return true;
+                double rhs;
+                if (!product(rhs)) return false;
+                value = add ? value + rhs : value - rhs;
+            }
+        }
+        
+        bool product(double& value) {
+            if (!unary(value)) return false;
+            while (true) {
+                std::string_view op = accept("*") ? "*" : accept("/") ? "/" : accept("MOD") ? "MOD" : "";
+                if (op.empty()) return true;
+                double rhs;
+                if (!unary(rhs)) return false;
+                if (op == "*") {
+                    value *= rhs;
+                    continue;
+                }
+                if (rhs == 0) return false;
+                if (op == "/") {
+                    value /= rhs;
+                } else {
+                    value = std::fmod(value, rhs);
+                    if (value < 0) value += std::fabs(rhs);
+                }
+            }
+        }
+        
+        bool unary(double& value) {
+            if (accept("-")) {
+                if (!unary(value)) return false;
+                value = -value;
+                return true;
+            }
+            if (accept("+")) return unary(value);
+            return power(value);
+        }
+        
+        // a^b^c is left out, as it is not obvious which way round the calculator groups it.
+        bool power(double& value) {
+            if (!primary(value)) return false;
+            if (!accept("^")) return true;
+            
+            double exponent;
+            bool negative = accept("-");
+            if (!negative) accept("+");
+            if (!primary(exponent)) return false;
+            if (_pos < _end && _tokens[_pos].text == "^") return false;
+            
+            value = std::pow(value, negative ? -exponent : exponent);
+            return std::isfinite(value);
+        }
+        
+        bool primary(double& value) {
+            if (_pos >= _end) return false;
+            const TToken& token = _tokens[_pos];
+            
+            if (token.type == Type::Number) {
+                _pos++;
+                return Expression::number(token.text, value);
+            }
+            if (accept("π")) {
+                value = M_PI;
+                return true;
+            }
+            if (accept("(")) {
+                return logical(value) && accept(")");
+            }
+            return false;
+        }
+    };
+}
+
+bool Expression::evaluate(const std::vector<TToken>& tokens, size_t first, size_t last, double& value) {
+    if (first > last || last >= tokens.size()) return false;
+    Parser parser(tokens, first, last);
+    return parser.parse(value);
+}
+
+bool Expression::number(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    
+    if (text.front() == '#') {
+        // #digits[:[-]bits][base]
+        std::string digits = text.substr(1);
+        int base = 10;
+        switch (digits.back()) {
+            case 'h': base = 16; break;
+            case 'o': base = 8; break;
+            case 'b': base = 2; break;
+            case 'd': base = 10; break;
+            default: return false;
+        }
+        digits.pop_back();
+        
+        int bits = 64;
+        bool isSigned = false;
+        size_t colon = digits.find(':');
+        if (colon != std::string::npos) {
+            std::string width = digits.substr(colon + 1);
+            digits.resize(colon);
+            if (!width.empty() && width.front() == '-') {
+                isSigned = true;
+                width.erase(0, 1);
+            }
+            bits = std::atoi(width.c_str());
+            if (bits < 1 || bits > 64) return false;
+        }
+        
+        char* end;
+        uint64_t n = std::strtoull(digits.c_str(), &end, base);
+        if (digits.empty() || *end) return false;
+        
+        if (bits < 64) n &= (1ULL << bits) - 1;
+        if (isSigned && bits < 64 && (n & (1ULL << (bits - 1)))) {
+            value = static_cast<double>(static_cast<int64_t>(n) - static_cast<int64_t>(1ULL << bits));
+        } else {
+            value = isSigned ? static_cast<double>(static_cast<int64_t>(n)) : static_cast<double>(n);
+        }
+        return true;
+    }
+    
+    std::string str = text;
+    for (size_t pos = str.find("ᴇ"); pos != std::string::npos; pos = str.find("ᴇ")) str.replace(pos, std::string("ᴇ").size(), "e");
+    
+    char* end;
+    value = std::strtod(str.c_str(), &end);
+    return *end == '\0';
+}
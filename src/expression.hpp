@@ -1,6 +1,8 @@
 // The MIT License (MIT)
 //
-// Copyright (c) 2023-2025 Insoft.
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -20,14 +22,31 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#pragma once
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <string>
+#include <vector>
 
-#include <iostream>
-#include <sstream>
-#include <regex>
-#include <list>
-#include <unordered_set>
+#include "lexer.hpp"
 
-namespace minifier {
-    std::string minify(const std::string& code);
+namespace pplplus {
+    /*
+     Evaluates PPL expressions made only of numbers, π and operators, as left in
+     the output once macros have been expanded, such as the 0 in IF 0 THEN.
+     
+     Arithmetic, comparisons, MOD and the logical AND, OR, XOR and NOT are supported,
+     with the same precedence as on the HP Prime. Anything else, including a division
+     by zero, makes the expression non-constant.
+     */
+    class Expression {
+    public:
+        // Evaluates tokens first to last inclusive.
+        static bool evaluate(const std::vector<Lexer::TToken>& tokens, size_t first, size_t last, double& value);
+        
+        // The value of a number such as 1.5ᴇ3, #FFh or #FF:32h.
+        static bool number(const std::string& text, double& value);
+    };
 }
+
+#endif // EXPRESSION_HPP
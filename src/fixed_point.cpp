@@ -0,0 +1,562 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "fixed_point.hpp"
+#include "lexer.hpp"
+
+#include <regex>
+#include <cmath>
+#include <sstream>
+#include <unordered_set>
+#include <unordered_map>
+
+using pplplus::FixedPoint;
+using pplplus::Lexer;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+static bool isRelational(const TToken& token) {
+    static const std::unordered_set<std::string> operators = {
+        "<", ">", "<=", ">=", "==", "=", "<>", "!=", "≠", "≤", "≥"
+    };
+    return token.type == Type::Operator && operators.count(token.text);
+}
+
+static bool isLogical(const TToken& token) {
+    return Lexer::isIdentifier(token, "AND") || Lexer::isIdentifier(token, "OR") || Lexer::isIdentifier(token, "XOR") || Lexer::isIdentifier(token, "NOT");
+}
+
+static bool opens(const TToken& token) {
+    return Lexer::isOperator(token, "(") || Lexer::isOperator(token, "[") || Lexer::isOperator(token, "{");
+}
+
+static bool closes(const TToken& token) {
+    return Lexer::isOperator(token, ")") || Lexer::isOperator(token, "]") || Lexer::isOperator(token, "}");
+}
+
+// Index of the bracket matching the one at index i, or last + 1.
+static size_t matching(const std::vector<TToken>& tokens, size_t i, size_t last) {
+    int depth = 0;
+    for (; i <= last; i++) {
+        if (opens(tokens[i])) depth++;
+        if (closes(tokens[i])) depth--;
+        if (depth == 0) return i;
+    }
+    return last + 1;
+}
+
+static std::string hex(long long value) {
+    std::ostringstream os;
+    if (value < 0) os << "-";
+    os << "#" << std::uppercase << std::hex << std::llabs(value) << ":64h";
+    return os.str();
+}
+
+// MARK: - Expressions
+
+namespace {
+    typedef struct TValue {
+        std::string text;
+        bool constant = false;
+        double value = 0;
+    } TValue;
+    
+    /*
+     Rewrites the real arithmetic of an expression as fixed-point arithmetic, folding
+     operations on numbers as it goes so that 1/3 becomes a single integer.
+     */
+    class Converter {
+    public:
+        std::string error;
+        std::unordered_set<std::string> helpers;
+        
+        Converter(std::string_view code, const std::vector<TToken>& tokens, const std::unordered_set<std::string>& fixed, int integerBits, int fractionBits)
+        : _code(code), _tokens(tokens), _fixed(fixed), _fractionBits(fractionBits) {
+            _max = (1LL << (integerBits + fractionBits - 1)) - 1;
+        }
+        
+        bool convert(size_t first, size_t last, std::string& result) {
+            error.clear();
+            _i = first;
+            _last = last;
+            
+            TValue value = sum();
+            if (error.empty() && _i <= _last) error = "unexpected '" + _tokens[_i].text + "'";
+            if (!error.empty()) return false;
+            
+            result = value.constant ? literal(value.value) : value.text;
+            return true;
+        }
+        
+        // The code from token first to last, with each fixed local converted to a real.
+        std::string real(size_t first, size_t last) {
+            std::string text;
+            for (size_t i = first; i <= last; i++) {
+                const TToken& token = _tokens[i];
+                if (i > first && token.space) text += " ";
+                if (isFixed(i)) {
+                    helpers.insert("fx_real");
+                    text += "fx_real(" + token.text + ")";
+                } else {
+                    text += token.text;
+                }
+            }
+            return text;
+        }
+        
+        bool mentionsFixed(size_t first, size_t last) const {
+            for (size_t i = first; i <= last; i++) {
+                if (isFixed(i)) return true;
+            }
+            return false;
+        }
+        
+        bool isFixed(size_t i) const {
+            if (_tokens[i].type != Type::Identifier || !_fixed.count(_tokens[i].text)) return false;
+            return i == 0 || !Lexer::isOperator(_tokens[i - 1], ".");
+        }
+        
+        std::string literal(double value) const {
+            double scaled = std::round(value * std::ldexp(1.0, _fractionBits));
+            if (scaled > static_cast<double>(_max)) scaled = static_cast<double>(_max);
+            if (scaled < -static_cast<double>(_max) - 1) scaled = -static_cast<double>(_max) - 1;
+            return hex(static_cast<long long>(scaled));
+        }
+        
+    private:
+        std::string_view _code;
+        const std::vector<TToken>& _tokens;
+        const std::unordered_set<std::string>& _fixed;
+        int _fractionBits;
+        long long _max;
+        size_t _i = 0;
+        size_t _last = 0;
+        
+        bool accept(std::string_view op) {
+            if (_i > _last || !Lexer::isOperator(_tokens[_i], op)) return false;
+            _i++;
+            return true;
+        }
+        
+        std::string text(const TValue& value) {
+            return value.constant ? literal(value.value) : value.text;
+        }
+        
+        TValue call(const std::string& helper, const TValue& a, const TValue& b) {
+            helpers.insert(helper);
+            return {helper + "(" + text(a) + ", " + text(b) + ")"};
+        }
+        
+        static bool isWhole(const TValue& value) {
+            return value.constant && value.value == std::round(value.value) && std::fabs(value.value) < 2147483648.0;
+        }
+        
+        TValue sum(void) {
+            TValue value = term();
+            while (error.empty()) {
+                bool add = accept("+");
+                if (!add && !accept("-")) break;
+                TValue other = term();
+                if (value.constant && other.constant) {
+                    value.value += add ? other.value : -other.value;
+                } else if (other.constant && other.value == 0) {
+                    continue;
+                } else {
+                    value = call(add ? "fx_add" : "fx_sub", value, other);
+                }
+            }
+            return value;
+        }
+        
+        TValue term(void) {
+            TValue value = unary();
+            while (error.empty()) {
+                bool multiply = accept("*");
+                if (!multiply && !accept("/")) break;
+                TValue other = unary();
+                if (!error.empty()) break;
+                
+                if (value.constant && other.constant && (multiply || other.value != 0)) {
+                    value.value = multiply ? value.value * other.value : value.value / other.value;
+                    continue;
+                }
+                
+                // A fixed number times a whole number needs no scaling.
+                if (multiply && (isWhole(value) || isWhole(other))) {
+                    const TValue& k = isWhole(value) ? value : other;
+                    const TValue& x = isWhole(value) ? other : value;
+                    if (k.value == 1) {
+                        value = x;
+                    } else {
+                        helpers.insert("fx_sat");
+                        value = {"fx_sat(" + text(x) + "*" + hex(static_cast<long long>(k.value)) + ")"};
+                    }
+                    continue;
+                }
+                
+                value = call(multiply ? "fx_mul" : "fx_div", value, other);
+            }
+            return value;
+        }
+        
+        TValue unary(void) {
+            if (accept("+")) return unary();
+            if (accept("-") || accept("−")) {
+                TValue value = unary();
+                if (value.constant) {
+                    value.value = -value.value;
+                    return value;
+                }
+                helpers.insert("fx_sat");
+                return {"fx_sat(-" + value.text + ")"};
+            }
+            return power();
+        }
+        
+        // Only small whole powers, as repeated multiplication.
+        TValue power(void) {
+            TValue value = primary();
+            if (!error.empty() || !accept("^")) return value;
+            
+            TValue exponent = unary();
+            if (!error.empty()) return value;
+            if (value.constant && exponent.constant) {
+                value.value = std::pow(value.value, exponent.value);
+                return value;
+            }
+            if (!isWhole(exponent) || exponent.value < 1 || exponent.value > 8) {
+                error = "'^' needs a whole power from 1 to 8";
+                return value;
+            }
+            
+            TValue result = value;
+            for (int n = 1; n < static_cast<int>(exponent.value); n++) result = call("fx_mul", result, value);
+            return result;
+        }
+        
+        TValue primary(void) {
+            if (_i > _last) {
+                error = "missing value";
+                return {};
+            }
+            
+            const TToken& token = _tokens[_i];
+            
+            if (accept("(")) {
+                TValue value = sum();
+                if (error.empty() && !accept(")")) error = "missing ')'";
+                return value;
+            }
+            
+            if (token.type == Type::Number && token.text.front() != '#') {
+                std::string number = token.text;
+                size_t e = number.find("ᴇ");
+                if (e != std::string::npos) number.replace(e, std::string("ᴇ").size(), "e");
+                _i++;
+                try {
+                    return {"", true, std::stod(number)};
+                } catch (...) {
+                    error = "'" + token.text + "' is not a number";
+                    return {};
+                }
+            }
+            
+            if (Lexer::isIdentifier(token, "π")) {
+                _i++;
+                return {"", true, M_PI};
+            }
+            
+            if (isFixed(_i) && !(_i < _last && Lexer::isOperator(_tokens[_i + 1], "("))) {
+                _i++;
+                return {token.text};
+            }
+            
+            if (token.type == Type::Identifier && !Lexer::isKeyword(token.text)) {
+                // A real operand, such as dt, L(i) or B→R(n), converted each time it is used.
+                size_t first = _i++;
+                while (_i + 1 <= _last && Lexer::isOperator(_tokens[_i], "→") && _tokens[_i + 1].type == Type::Identifier) _i += 2;
+                if (_i <= _last && Lexer::isOperator(_tokens[_i], "(")) {
+                    size_t close = matching(_tokens, _i, _last);
+                    if (close > _last) {
+                        error = "missing ')'";
+                        return {};
+                    }
+                    _i = close + 1;
+                }
+                helpers.insert("fx_from");
+                return {"fx_from(" + real(first, _i - 1) + ")"};
+            }
+            
+            error = "unexpected '" + token.text + "'";
+            return {};
+        }
+    };
+}
+
+// MARK: - Helpers
+
+// The helpers in the order they must be declared, with those each one calls.
+static const std::vector<std::pair<std::string, std::vector<std::string>>> dependencies = {
+    {"fx_sat", {}},
+    {"fx_add", {"fx_sat"}},
+    {"fx_sub", {"fx_sat"}},
+    {"fx_mul", {"fx_sat"}},
+    {"fx_div", {"fx_sat"}},
+    {"fx_from", {}},
+    {"fx_real", {}}
+};
+
+static std::string helper(const std::string& name, int fractionBits, long long max) {
+    std::string n = std::to_string(fractionBits);
+    std::string scale = std::to_string(1LL << fractionBits);
+    std::string high = hex(max);
+    std::string low = "-" + hex(max + 1);
+    
+    if (name == "fx_sat") {
+        return "fx_sat(a)\nBEGIN\n"
+        "  IF a > " + high + " THEN RETURN " + high + "; END;\n"
+        "  IF a < " + low + " THEN RETURN " + low + "; END;\n"
+        "  RETURN a;\nEND;\n";
+    }
+    if (name == "fx_add") return "fx_add(a, b)\nBEGIN\n  RETURN fx_sat(a + b);\nEND;\n";
+    if (name == "fx_sub") return "fx_sub(a, b)\nBEGIN\n  RETURN fx_sat(a - b);\nEND;\n";
+    if (name == "fx_mul") {
+        return "fx_mul(a, b)\nBEGIN\n"
+        "  LOCAL p := a * b;\n"
+        "  IF p < 0 THEN RETURN fx_sat(-BITSR(-p, " + n + ")); END;\n"
+        "  RETURN fx_sat(BITSR(p, " + n + "));\nEND;\n";
+    }
+    if (name == "fx_div") {
+        return "fx_div(a, b)\nBEGIN\n"
+        "  LOCAL q;\n"
+        "  IF b == 0 THEN RETURN IFTE(a < 0, " + low + ", " + high + "); END;\n"
+        "  q := R→B(IP(BITSL(ABS(a), " + n + ") / ABS(b)));\n"
+        "  IF (a < 0) XOR (b < 0) THEN RETURN fx_sat(-q); END;\n"
+        "  RETURN fx_sat(q);\nEND;\n";
+    }
+    if (name == "fx_from") {
+        return "fx_from(x)\nBEGIN\n"
+        "  x := MAX(MIN(ROUND(x * " + scale + ", 0), " + std::to_string(max) + "), " + std::to_string(-max - 1) + ");\n"
+        "  IF x < 0 THEN RETURN -R→B(-x); END;\n"
+        "  RETURN R→B(x);\nEND;\n";
+    }
+    if (name == "fx_real") {
+        return "fx_real(a)\nBEGIN\n"
+        "  IF a < 0 THEN RETURN -B→R(-a) / " + scale + "; END;\n"
+        "  RETURN B→R(a) / " + scale + ";\nEND;\n";
+    }
+    return "";
+}
+
+// MARK: -
+
+bool FixedPoint::format(const std::string& q) {
+    static const std::regex re(R"(^[Qq](\d+)\.(\d+)$)");
+    std::smatch match;
+    if (!std::regex_match(q, match, re)) return false;
+    
+    int m = std::stoi(match.str(1));
+    int n = std::stoi(match.str(2));
+    if (m < 1 || n < 1 || m + n > 32) return false;
+    
+    integerBits = m;
+    fractionBits = n;
+    return true;
+}
+
+std::string FixedPoint::convert(const std::string& code) {
+    _report = {};
+    _problems.clear();
+    
+    auto tokens = Lexer::tokenize(code);
+    auto functions = Lexer::functions(tokens);
+    
+    Edits edits;
+    std::unordered_set<std::string> helpers;
+    
+    for (const auto& function : functions) {
+        if (function.end >= tokens.size()) continue;
+        
+        std::unordered_set<std::string> fixed;
+        for (size_t i = function.begin + 1; i + 1 < function.end; i++) {
+            if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isIdentifier(tokens[i + 1], "FIXED") || !Lexer::isStatementStart(tokens, i)) continue;
+            size_t end = Lexer::statementEnd(tokens, i);
+            bool declarator = true;
+            for (size_t j = i + 2; j <= end && j < function.end; j++) {
+                if (opens(tokens[j])) j = matching(tokens, j, end);
+                else if (Lexer::isOperator(tokens[j], ",")) declarator = true;
+                else if (declarator && tokens[j].type == Type::Identifier) {
+                    fixed.insert(tokens[j].text);
+                    declarator = false;
+                } else declarator = false;
+            }
+            i = end;
+        }
+        if (fixed.empty()) continue;
+        _report.variables += fixed.size();
+        
+        Converter converter(code, tokens, fixed, integerBits, fractionBits);
+        std::vector<bool> covered(tokens.size(), false);
+        
+        auto problem = [&](size_t i, const std::string& reason) {
+            _problems.push_back({function.name, tokens[i].line, reason});
+        };
+        
+        auto replace = [&](size_t first, size_t last, const std::string& text) {
+            size_t offset = tokens[first].offset;
+            if (edits.add({offset, tokens[last].offset + tokens[last].text.size() - offset, text})) {
+                for (size_t i = first; i <= last; i++) covered[i] = true;
+                _report.statements++;
+            }
+        };
+        
+        // Converts the comparisons of a condition that have a fixed local on either side.
+        auto condition = [&](size_t first, size_t last) {
+            size_t start = first;
+            for (size_t i = first; i <= last + 1; i++) {
+                if (i <= last && opens(tokens[i])) {
+                    i = matching(tokens, i, last);
+                    continue;
+                }
+                if (i <= last && !isLogical(tokens[i])) continue;
+                
+                size_t a = start, b = i - 1;
+                start = i + 1;
+                if (a > b || b > last) continue;
+                while (a < b && Lexer::isOperator(tokens[a], "(") && matching(tokens, a, b) == b) {
+                    a++;
+                    b--;
+                }
+                
+                size_t op = b + 1;
+                for (size_t j = a; j <= b; j++) {
+                    if (opens(tokens[j])) j = matching(tokens, j, b);
+                    else if (isRelational(tokens[j])) {
+                        op = j;
+                        break;
+                    }
+                }
+                if (op > b || op == a || op == b || !converter.mentionsFixed(a, b)) continue;
+                
+                std::string left, right;
+                if (!converter.convert(a, op - 1, left) || !converter.convert(op + 1, b, right)) {
+                    problem(a, "comparison not converted: " + converter.error);
+                    continue;
+                }
+                replace(a, b, left + " " + tokens[op].text + " " + right);
+            }
+        };
+        
+        for (size_t i = function.begin + 1; i < function.end; i++) {
+            const TToken& token = tokens[i];
+            if (!Lexer::isStatementStart(tokens, i) && !Lexer::isIdentifier(token, "UNTIL")) continue;
+            
+            if (Lexer::isIdentifier(token, "LOCAL") && Lexer::isIdentifier(tokens[i + 1], "FIXED")) {
+                size_t end = Lexer::statementEnd(tokens, i);
+                size_t last = Lexer::isOperator(tokens[end], ";") ? end - 1 : end;
+                
+                std::string text = "LOCAL ";
+                bool valid = true;
+                for (size_t j = i + 2; j <= last && valid; j++) {
+                    size_t k = j;
+                    while (k <= last && !Lexer::isOperator(tokens[k], ",")) {
+                        if (opens(tokens[k])) k = matching(tokens, k, last);
+                        k++;
+                    }
+                    
+                    std::string value = hex(0);
+                    if (j + 1 < k && Lexer::isOperator(tokens[j + 1], ":=") && !converter.convert(j + 2, k - 1, value)) {
+                        problem(j, "'" + tokens[j].text + "' not initialised: " + converter.error);
+                        valid = false;
+                    }
+                    text += (j > i + 2 ? ", " : "") + tokens[j].text + " := " + value;
+                    j = k;
+                }
+                if (valid) replace(i, last, text);
+                i = end;
+                continue;
+            }
+            
+            if (converter.isFixed(i) && i + 1 < function.end && Lexer::isOperator(tokens[i + 1], ":=")) {
+                size_t end = Lexer::statementEnd(tokens, i);
+                size_t last = Lexer::isOperator(tokens[end], ";") ? end - 1 : end;
+                
+                std::string value;
+                if (converter.convert(i + 2, last, value)) replace(i + 2, last, value);
+                else problem(i, "'" + token.text + "' not assigned in fixed point: " + converter.error);
+                covered[i] = true;
+                continue;
+            }
+            
+            if (Lexer::isIdentifier(token, "FOR") && i + 1 < function.end && converter.isFixed(i + 1)) {
+                problem(i, "FOR counts with fixed local '" + tokens[i + 1].text + "'");
+                covered[i + 1] = true;
+                continue;
+            }
+            
+            std::string_view until;
+            if (Lexer::isIdentifier(token, "IF")) until = "THEN";
+            if (Lexer::isIdentifier(token, "WHILE")) until = "DO";
+            if (Lexer::isIdentifier(token, "UNTIL")) until = ";";
+            if (until.empty()) continue;
+            
+            size_t j = i + 1;
+            while (j < function.end && tokens[j].text != until) {
+                if (opens(tokens[j])) j = matching(tokens, j, function.end - 1);
+                j++;
+            }
+            if (j > i + 1) condition(i + 1, j - 1);
+        }
+        
+        // Any other use of a fixed local reads it as a real.
+        for (size_t i = function.begin + 1; i < function.end; i++) {
+            if (covered[i] || !converter.isFixed(i)) continue;
+            if (i > 0 && Lexer::isOperator(tokens[i - 1], "▶")) {
+                problem(i, "'" + tokens[i].text + "' assigned with ▶");
+                continue;
+            }
+            edits.add({tokens[i].offset, tokens[i].text.size(), converter.real(i, i)});
+        }
+        
+        helpers.insert(converter.helpers.begin(), converter.helpers.end());
+    }
+    
+    if (edits.empty()) return code;
+    
+    // Helpers come ahead of the first function, along with those they call.
+    std::string text;
+    for (auto it = dependencies.rbegin(); it != dependencies.rend(); ++it) {
+        if (helpers.count(it->first)) helpers.insert(it->second.begin(), it->second.end());
+    }
+    for (const auto& dependency : dependencies) {
+        if (helpers.count(dependency.first)) text += helper(dependency.first, fractionBits, (1LL << (integerBits + fractionBits - 1)) - 1) + "\n";
+    }
+    if (!text.empty() && !functions.empty()) {
+        edits.add({tokens[functions.front().start].offset, 0, text});
+    }
+    
+    return edits.apply(code);
+}
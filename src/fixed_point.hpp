@@ -0,0 +1,85 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIXED_POINT_HPP
+#define FIXED_POINT_HPP
+
+#include <string>
+#include <vector>
+
+namespace pplplus {
+    /*
+     #pragma mode( fixed(Q16.16) )
+     
+     Computes with locals declared LOCAL FIXED as signed fixed-point numbers held in the
+     HP Prime's 64-bit integers, which are much faster than its reals. Q16.16 has 16
+     integer bits, including the sign, and 16 fraction bits. Words are at most 32 bits,
+     so that the product of two of them fits in 64 bits before it is scaled back.
+     
+     - An assignment to a fixed local has its expression computed in fixed point. Numbers
+       become #...:64h integers, + - * / become calls to helpers that shift and saturate,
+       and anything else, such as SIN(t) or a real variable, is converted when used.
+     - A comparison with a fixed local on either side is made between integers.
+     - A fixed local used anywhere else is converted back to a real.
+     
+     Only the helpers used are added, ahead of the first function. Statements that
+     cannot be converted, such as a FOR loop counting with a fixed local, are reported.
+     */
+    class FixedPoint {
+    public:
+        typedef struct TReport {
+            size_t variables;
+            size_t statements;
+        } TReport;
+        
+        typedef struct TProblem {
+            std::string function;
+            long line;
+            std::string reason;
+        } TProblem;
+        
+        int integerBits = 16;
+        int fractionBits = 16;
+        
+        // Sets the format from Qm.n, false if it is not valid.
+        bool format(const std::string& q);
+        
+        std::string convert(const std::string& code);
+        
+        TReport report(void) const {
+            return _report;
+        }
+        
+        // Uses of fixed locals the last call to convert could not convert.
+        const std::vector<TProblem>& problems(void) const {
+            return _problems;
+        }
+        
+    private:
+        TReport _report = {};
+        std::vector<TProblem> _problems;
+    };
+}
+
+#endif // FIXED_POINT_HPP
@@ -0,0 +1,404 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "inliner.hpp"
+#include "lexer.hpp"
+
+#include <unordered_set>
+#include <unordered_map>
+
+using pplplus::Inliner;
+using pplplus::Lexer;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 4
+
+// A function that calls can be replaced by.
+typedef struct TCandidate {
+    const Lexer::TFunction* function;
+    bool expression;                    // RETURN expression; rather than statements.
+    size_t first;                       // The expression, or the statements of the body.
+    size_t last;
+    std::vector<std::string> params;
+    std::unordered_set<std::string> locals;
+    std::unordered_set<std::string> assigned;
+    std::unordered_set<std::string> globals;
+} TCandidate;
+
+typedef struct TArgument {
+    size_t first;
+    size_t last;
+} TArgument;
+
+// A name, such as a field after a '.', that is not a variable.
+static bool isMember(const std::vector<TToken>& tokens, size_t i) {
+    return i > 0 && Lexer::isOperator(tokens[i - 1], ".");
+}
+
+// Names declared by LOCAL statements from token first to last.
+static std::unordered_set<std::string> locals(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    std::unordered_set<std::string> names;
+    for (size_t i = first; i <= last; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isStatementStart(tokens, i)) continue;
+        size_t end = Lexer::statementEnd(tokens, i);
+        int depth = 0;
+        bool declarator = true;
+        for (size_t j = i + 1; j <= end && j <= last; j++) {
+            const TToken& token = tokens[j];
+            if (token.type == Type::Operator) {
+                if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+                if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+                if (depth == 0 && token.text == ",") declarator = true;
+                continue;
+            }
+            if (declarator && depth == 0 && token.type == Type::Identifier) names.insert(token.text);
+            declarator = false;
+        }
+        i = end;
+    }
+    return names;
+}
+
+static std::vector<std::string> parameters(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    std::vector<std::string> params;
+    for (size_t i = function.params + 1; i < function.begin; i++) {
+        if (Lexer::isOperator(tokens[i], ")")) break;
+        if (tokens[i].type == Type::Identifier) params.push_back(tokens[i].text);
+    }
+    return params;
+}
+
+// VIEW "Title", Function() ahead of a function makes it an entry point in the Apps view.
+static bool isViewed(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    size_t i = function.start;
+    return i >= 3 && Lexer::isOperator(tokens[i - 1], ",") && tokens[i - 2].type == Type::String &&
+    Lexer::isIdentifier(tokens[i - 3], "VIEW");
+}
+
+static bool candidate(const std::vector<TToken>& tokens, const Lexer::TFunction& function,
+                      const std::unordered_map<std::string, size_t>& definitions, size_t budget, TCandidate& result) {
+    if (function.exported || function.end >= tokens.size() || isViewed(tokens, function)) return false;
+    
+    size_t first = function.begin + 1;
+    size_t last = function.end - 1;
+    if (first > last || last - first + 1 > budget) return false;
+    
+    result = TCandidate{&function, false, first, last, parameters(tokens, function), {}, {}, {}};
+    std::unordered_set<std::string> params(result.params.begin(), result.params.end());
+    if (params.size() != result.params.size()) return false;
+    
+    bool returns = false;
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Directive) return false;
+        if (Lexer::isIdentifier(token, "RETURN")) returns = true;
+        if (token.type != Type::Identifier) continue;
+        
+        // Only leaf functions, which also rules out recursion.
+        if (definitions.contains(token.text) && !isMember(tokens, i)) return false;
+    }
+    
+    if (returns) {
+        // BEGIN RETURN expression; END
+        if (!Lexer::isIdentifier(tokens[first], "RETURN")) return false;
+        size_t end = Lexer::statementEnd(tokens, first);
+        if (end != last) return false;
+        if (Lexer::isOperator(tokens[end], ";")) end--;
+        if (end <= first) return false;
+        for (size_t i = first + 1; i <= end; i++) {
+            if (Lexer::isOperator(tokens[i], ":=") || Lexer::isOperator(tokens[i], "▶")) return false;
+        }
+        result.expression = true;
+        result.first = first + 1;
+        result.last = end;
+    } else {
+        result.locals = locals(tokens, first, last);
+    }
+    
+    for (size_t i = result.first; i <= result.last; i++) {
+        const TToken& token = tokens[i];
+        if (!Lexer::isName(token) || isMember(tokens, i)) continue;
+        if (params.contains(token.text)) {
+            // Writing to an element of a list parameter, as in L(1) := 0, counts as well.
+            size_t next = i + 1;
+            if (next <= result.last && (Lexer::isOperator(tokens[next], "(") || Lexer::isOperator(tokens[next], "["))) {
+                next = Lexer::closing(tokens, next, result.last + 1) + 1;
+            }
+            bool written = (next <= result.last && Lexer::isOperator(tokens[next], ":=")) ||
+            (i > result.first && (Lexer::isOperator(tokens[i - 1], "▶") || Lexer::isIdentifier(tokens[i - 1], "FOR")));
+            if (written) result.assigned.insert(token.text);
+            continue;
+        }
+        if (!result.locals.contains(token.text)) result.globals.insert(token.text);
+    }
+    
+    return true;
+}
+
+static std::vector<TArgument> arguments(const std::vector<TToken>& tokens, size_t open, size_t close) {
+    std::vector<TArgument> args;
+    if (close == open + 1) return args;
+    
+    int depth = 0;
+    size_t first = open + 1;
+    for (size_t i = open + 1; i < close; i++) {
+        const TToken& token = tokens[i];
+        if (token.type != Type::Operator) continue;
+        if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+        if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+        if (depth == 0 && token.text == ",") {
+            args.push_back({first, i - 1});
+            first = i + 1;
+        }
+    }
+    args.push_back({first, close - 1});
+    return args;
+}
+
+/*
+ A number, string, or local or parameter of the caller, which can stand in for a parameter
+ as it is. Any other name may be a built-in such as RANDOM, which must not run twice.
+ */
+static bool isSimple(const std::vector<TToken>& tokens, const TArgument& arg, const std::unordered_set<std::string>& names) {
+    if (arg.first != arg.last) return false;
+    const TToken& token = tokens[arg.first];
+    return token.type == Type::Number || token.type == Type::String || (Lexer::isName(token) && names.contains(token.text));
+}
+
+// An argument that may call a function, or index a list, and so must be evaluated exactly once.
+static bool hasCall(const std::vector<TToken>& tokens, const TArgument& arg) {
+    for (size_t i = arg.first; i <= arg.last; i++) {
+        if (Lexer::isOperator(tokens[i], ":=") || Lexer::isOperator(tokens[i], "▶")) return true;
+        if (Lexer::isName(tokens[i]) && i + 1 <= arg.last && (Lexer::isOperator(tokens[i + 1], "(") || Lexer::isOperator(tokens[i + 1], "["))) return true;
+    }
+    return false;
+}
+
+static std::string indentation(std::string_view code, size_t offset) {
+    size_t start = code.rfind('\n', offset);
+    start = start == std::string_view::npos ? 0 : start + 1;
+    size_t end = start;
+    while (end < offset && (code[end] == ' ' || code[end] == '\t')) end++;
+    return std::string(code.substr(start, end - start));
+}
+
+/*
+ The code from token first to last, with replacements for some of the tokens, and each
+ line moved from the indentation of the function to that of the call.
+ */
+static std::string rebuild(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last,
+                           const std::unordered_map<size_t, std::string>& replacements, const std::string& indent) {
+    std::string base = indentation(code, tokens[first].offset);
+    std::string text;
+    
+    for (size_t i = first; i <= last; i++) {
+        if (i > first) {
+            size_t end = tokens[i - 1].offset + tokens[i - 1].text.size();
+            std::string_view gap = code.substr(end, tokens[i].offset - end);
+            size_t newline = gap.rfind('\n');
+            if (newline == std::string_view::npos) {
+                text += gap;
+            } else {
+                std::string_view margin = gap.substr(newline + 1);
+                if (margin.starts_with(base)) margin.remove_prefix(base.size());
+                text += "\n" + indent;
+                text += margin;
+            }
+        }
+        auto it = replacements.find(i);
+        text += it != replacements.end() ? it->second : tokens[i].text;
+    }
+    
+    return text;
+}
+
+// MARK: - Call Sites
+
+static bool inlineExpression(std::string_view code, const std::vector<TToken>& tokens, const TCandidate& callee,
+                             size_t call, size_t close, const std::unordered_set<std::string>& names, Edits& edits) {
+    std::vector<TArgument> args = arguments(tokens, call + 1, close);
+    if (args.size() != callee.params.size()) return false;
+    
+    std::unordered_map<std::string, size_t> uses;
+    for (size_t i = callee.first; i <= callee.last; i++) {
+        if (Lexer::isName(tokens[i]) && !isMember(tokens, i)) uses[tokens[i].text]++;
+    }
+    
+    std::unordered_map<std::string, std::string> substitutes;
+    size_t calls = 0;
+    for (size_t n = 0; n < args.size(); n++) {
+        const std::string& param = callee.params[n];
+        const TArgument& arg = args[n];
+        bool simple = isSimple(tokens, arg, names);
+        
+        if (hasCall(tokens, arg)) {
+            if (uses[param] != 1 || ++calls > 1) return false;
+        }
+        if (!simple && uses[param] > 1) return false;
+        
+        std::string text(Lexer::text(code, tokens, arg.first, arg.last));
+        substitutes[param] = simple ? text : "(" + text + ")";
+    }
+    
+    std::unordered_map<size_t, std::string> replacements;
+    for (size_t i = callee.first; i <= callee.last; i++) {
+        if (!Lexer::isName(tokens[i]) || isMember(tokens, i) || !substitutes.contains(tokens[i].text)) continue;
+        const std::string& text = substitutes[tokens[i].text];
+        
+        // (a+b)(2) is not the same as indexing a list passed by name.
+        if (text.starts_with("(") && i + 1 <= callee.last && (Lexer::isOperator(tokens[i + 1], "(") || Lexer::isOperator(tokens[i + 1], "["))) {
+            return false;
+        }
+        replacements[i] = text;
+    }
+    
+    std::string text = rebuild(code, tokens, callee.first, callee.last, replacements, "");
+    if (callee.first != callee.last) text = "(" + text + ")";
+    
+    size_t start = tokens[call].offset;
+    return edits.add({start, tokens[close].offset + 1 - start, text});
+}
+
+static bool inlineStatements(std::string_view code, const std::vector<TToken>& tokens, const TCandidate& callee,
+                             size_t call, size_t close, const std::unordered_set<std::string>& names,
+                             std::unordered_set<std::string>& used, Edits& edits) {
+    std::vector<TArgument> args = arguments(tokens, call + 1, close);
+    if (args.size() != callee.params.size()) return false;
+    
+    const std::string prefix = callee.function->name + "_";
+    std::unordered_map<std::string, std::string> substitutes;
+    std::string declarations;
+    
+    for (size_t n = 0; n < args.size(); n++) {
+        const std::string& param = callee.params[n];
+        const TArgument& arg = args[n];
+        std::string text(Lexer::text(code, tokens, arg.first, arg.last));
+        
+        if (isSimple(tokens, arg, names) && !callee.assigned.contains(param)) {
+            substitutes[param] = text;
+            continue;
+        }
+        substitutes[param] = Lexer::fresh(prefix + param, used);
+        declarations += (declarations.empty() ? "LOCAL " : ", ") + substitutes[param] + " := " + text;
+    }
+    for (const std::string& local : callee.locals) {
+        substitutes[local] = Lexer::fresh(prefix + local, used);
+    }
+    
+    std::unordered_map<size_t, std::string> replacements;
+    for (size_t i = callee.first; i <= callee.last; i++) {
+        if (!Lexer::isName(tokens[i]) || isMember(tokens, i) || !substitutes.contains(tokens[i].text)) continue;
+        replacements[i] = substitutes[tokens[i].text];
+    }
+    
+    std::string indent = indentation(code, tokens[call].offset);
+    std::string text;
+    if (!declarations.empty()) text = declarations + ";\n" + indent;
+    text += rebuild(code, tokens, callee.first, callee.last, replacements, indent);
+    
+    size_t last = close;
+    if (close + 1 < tokens.size() && Lexer::isOperator(tokens[close + 1], ";")) {
+        last = close + 1;
+        if (!Lexer::isOperator(tokens[callee.last], ";")) text += ";";
+    }
+    
+    size_t start = tokens[call].offset;
+    return edits.add({start, tokens[last].offset + tokens[last].text.size() - start, text});
+}
+
+// MARK: - Public Methods
+
+std::string Inliner::inlineCalls(const std::string& code) {
+    _sites.clear();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        std::vector<Lexer::TFunction> functions = Lexer::functions(tokens);
+        
+        std::unordered_map<std::string, size_t> definitions;
+        for (const Lexer::TFunction& function : functions) definitions[function.name]++;
+        
+        std::unordered_map<std::string, TCandidate> candidates;
+        for (const Lexer::TFunction& function : functions) {
+            TCandidate callee;
+            if (definitions[function.name] != 1 || !candidate(tokens, function, definitions, budget, callee)) continue;
+            candidates[function.name] = callee;
+        }
+        if (candidates.empty()) break;
+        
+        // Every name in the program, so that new locals clash with none of them.
+        std::unordered_set<std::string> used;
+        for (const TToken& token : tokens) {
+            if (token.type == Type::Identifier) used.insert(token.text);
+            if (token.type == Type::String || token.type == Type::Directive) {
+                for (std::string_view word : Lexer::words(token.text)) used.insert(std::string(word));
+            }
+        }
+        
+        Edits edits;
+        for (const Lexer::TFunction& caller : functions) {
+            if (caller.end >= tokens.size()) continue;
+            
+            std::unordered_set<std::string> names = locals(tokens, caller.begin + 1, caller.end - 1);
+            for (const std::string& param : parameters(tokens, caller)) names.insert(param);
+            
+            for (size_t i = caller.begin + 1; i < caller.end; i++) {
+                auto it = candidates.find(tokens[i].text);
+                if (tokens[i].type != Type::Identifier || it == candidates.end() || isMember(tokens, i)) continue;
+                if (i + 1 >= caller.end || !Lexer::isOperator(tokens[i + 1], "(")) continue;
+                
+                const TCandidate& callee = it->second;
+                size_t close = Lexer::closing(tokens, i + 1, caller.end);
+                if (close >= caller.end) continue;
+                
+                // A global of the callee hidden by a local of the caller.
+                bool captured = false;
+                for (const std::string& global : callee.globals) {
+                    if (names.contains(global)) captured = true;
+                }
+                
+                bool inlined = false;
+                if (!captured && callee.expression) {
+                    inlined = inlineExpression(result, tokens, callee, i, close, names, edits);
+                } else if (!captured && Lexer::isStatementStart(tokens, i) &&
+                           (close + 1 >= caller.end || Lexer::isOperator(tokens[close + 1], ";") || Lexer::isIdentifier(tokens[close + 1], "END"))) {
+                    inlined = inlineStatements(result, tokens, callee, i, close, names, used, edits);
+                }
+                if (!inlined) continue;
+                
+                _sites.push_back({caller.name, callee.function->name, tokens[i].line});
+                i = close;
+            }
+        }
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
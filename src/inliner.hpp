@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INLINER_HPP
+#define INLINER_HPP
+
+#include <string>
+#include <vector>
+
+#define INLINE_BUDGET 32
+
+namespace pplplus {
+    /*
+     Replaces calls to small functions with the body of the function, saving the cost of
+     a call on the calculator.
+     
+     Only functions that are not exported, whose body is at most budget tokens and that
+     call no other function of the program are inlined. That rules out recursion, while
+     a helper that calls another helper becomes a candidate once that one has been
+     inlined into it.
+     
+     - A function whose body is just RETURN expression; is inlined anywhere it is called,
+       as the expression with the arguments in place of the parameters.
+     - Any other function without a RETURN is inlined where it is called as a statement
+       of its own. Parameters that are assigned to in the body, or that are passed
+       something other than a plain variable or number, become new locals. The locals of
+       the body are renamed so they cannot clash with those of the caller.
+     
+     A call is left alone if the function refers to a global that the caller has a
+     local of the same name for. Functions that are no longer called are left in place
+     for --tree-shake to remove.
+     */
+    class Inliner {
+    public:
+        typedef struct TSite {
+            std::string caller;
+            std::string callee;
+            long line;
+        } TSite;
+        
+        size_t budget = INLINE_BUDGET;
+        
+        std::string inlineCalls(const std::string& code);
+        
+        // Calls inlined by the last call to inlineCalls, with the line each was on when it was inlined.
+        const std::vector<TSite>& sites(void) const {
+            return _sites;
+        }
+        
+    private:
+        std::vector<TSite> _sites;
+    };
+}
+
+#endif // INLINER_HPP
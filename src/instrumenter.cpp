@@ -0,0 +1,313 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "instrumenter.hpp"
+#include "lexer.hpp"
+
+#include <regex>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+
+using pplplus::Instrumenter;
+using pplplus::Lexer;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+// Two entries per site in a list of at most 10,000.
+#define SITE_LIMIT 4999
+
+static bool isLoop(const std::vector<TToken>& tokens, size_t i) {
+    const TToken& token = tokens[i];
+    return (Lexer::isIdentifier(token, "FOR") || Lexer::isIdentifier(token, "WHILE") || Lexer::isIdentifier(token, "REPEAT")) && Lexer::isStatementStart(tokens, i);
+}
+
+// The spaces before the token at index i when it starts a line, otherwise an empty string.
+static std::string indentation(std::string_view code, const TToken& token) {
+    if (!token.newline) return "";
+    size_t start = code.rfind('\n', token.offset);
+    start = start == std::string_view::npos ? 0 : start + 1;
+    return std::string(code.substr(start, token.offset - start));
+}
+
+/*
+ Calls visit for each site of the program in order, with the index of the token that
+ starts it, FUNCTION sites being given the index of BEGIN.
+ */
+template <typename Visit>
+static void visitSites(const std::vector<TToken>& tokens, const std::vector<Lexer::TFunction>& functions,
+                  const std::unordered_set<std::string>& skip, bool loops, Visit visit) {
+    size_t count = 0;
+    for (const auto& function : functions) {
+        if (function.end >= tokens.size() || skip.count(function.name)) continue;
+        if (++count > SITE_LIMIT) return;
+        visit(function, std::string("FUNCTION"), function.begin);
+        if (!loops) continue;
+        
+        for (size_t i = function.begin + 1; i < function.end; i++) {
+            if (!isLoop(tokens, i)) continue;
+            if (++count > SITE_LIMIT) return;
+            visit(function, tokens[i].text, i);
+        }
+    }
+}
+
+// MARK: -
+
+std::string Instrumenter::instrument(const std::string& code) {
+    _sites.clear();
+    
+    auto tokens = Lexer::tokenize(code);
+    auto functions = Lexer::functions(tokens);
+    if (functions.empty()) return code;
+    
+    std::unordered_set<std::string> used;
+    for (const auto& token : tokens) {
+        if (token.type == Type::Identifier) used.insert(token.text);
+    }
+    _list = Lexer::fresh("prof", used);
+    std::string exit = Lexer::fresh("prof_exit", used);
+    std::string timer = Lexer::fresh("prof_t", used);
+    
+    Edits edits;
+    visitSites(tokens, functions, {}, loops, [&](const Lexer::TFunction& function, const std::string& kind, size_t i) {
+        std::string index = std::to_string(_sites.size() * 2 + 1);
+        _sites.push_back({function.name, kind, 0, ""});
+        
+        if (kind != "FUNCTION") {
+            std::string name = Lexer::fresh("prof_l", used);
+            std::string indent = indentation(code, tokens[i]);
+            std::string separator = indent.empty() && !tokens[i].newline ? " " : "\n" + indent;
+            edits.add({tokens[i].offset, 0, "LOCAL " + name + " := TICKS;" + separator});
+            
+            size_t end = Lexer::statementEnd(tokens, i);
+            std::string text = (Lexer::isOperator(tokens[end], ";") ? "" : ";") + separator + exit + "(" + index + ", " + name + ", 0);";
+            edits.add({tokens[end].offset + tokens[end].text.size(), 0, text});
+            return;
+        }
+        
+        const TToken& begin = tokens[function.begin];
+        edits.add({begin.offset + begin.text.size(), 0, "\n  LOCAL " + timer + " := TICKS;"});
+        
+        for (size_t j = function.begin + 1; j < function.end; j++) {
+            if (!Lexer::isIdentifier(tokens[j], "RETURN") || !Lexer::isStatementStart(tokens, j)) continue;
+            size_t end = Lexer::statementEnd(tokens, j);
+            size_t last = Lexer::isOperator(tokens[end], ";") ? end - 1 : end;
+            
+            if (last == j) {
+                edits.add({tokens[j].offset + tokens[j].text.size(), 0, " " + exit + "(" + index + ", " + timer + ", 0)"});
+            } else {
+                edits.add({tokens[j + 1].offset, 0, exit + "(" + index + ", " + timer + ", "});
+                edits.add({tokens[last].offset + tokens[last].text.size(), 0, ")"});
+            }
+        }
+        
+        /*
+         Falling off the end also returns, unless the last statement is a RETURN, with the
+         value of the last statement, which is passed through when it is an expression or
+         an assignment.
+         */
+        size_t last = function.begin + 1;
+        for (size_t j = last; j < function.end; j = Lexer::statementEnd(tokens, j) + 1) last = j;
+        if (Lexer::isIdentifier(tokens[last], "RETURN")) return;
+        
+        if (tokens[last].type == Type::Identifier && Lexer::isKeyword(tokens[last].text)) {
+            edits.add({tokens[function.end].offset, 0, "  " + exit + "(" + index + ", " + timer + ", 0);\n"});
+            return;
+        }
+        
+        size_t end = Lexer::statementEnd(tokens, last);
+        if (Lexer::isOperator(tokens[end], ";") || Lexer::isIdentifier(tokens[end], "END")) end--;
+        
+        std::string value;
+        for (size_t j = last; j <= end; j++) {
+            if (Lexer::isOperator(tokens[j], ":=") && j > last) value = Lexer::text(code, tokens, last, j - 1);
+            if (Lexer::isOperator(tokens[j], "▶") && j < end) value = Lexer::text(code, tokens, j + 1, end);
+        }
+        
+        if (value.empty()) {
+            edits.add({tokens[last].offset, 0, exit + "(" + index + ", " + timer + ", "});
+            edits.add({tokens[end].offset + tokens[end].text.size(), 0, ")"});
+        } else {
+            edits.add({tokens[function.end].offset, 0, "  " + exit + "(" + index + ", " + timer + ", " + value + ");\n"});
+        }
+    });
+    
+    std::string zeros;
+    for (size_t i = 0; i < _sites.size() * 2; i++) zeros += i ? ",0" : "0";
+    
+    std::string runtime;
+    runtime += "EXPORT " + _list + " := {" + zeros + "};\n\n";
+    runtime += exit + "(k, t, value)\n";
+    runtime += "BEGIN\n";
+    runtime += "  " + _list + "(k) := " + _list + "(k) + 1;\n";
+    runtime += "  " + _list + "(k + 1) := " + _list + "(k + 1) + TICKS - t;\n";
+    runtime += "  RETURN value;\n";
+    runtime += "END;\n\n";
+    edits.add({tokens[functions.front().start].offset, 0, runtime});
+    
+    std::string result = edits.apply(code);
+    
+    // The lines the sites ended up on.
+    tokens = Lexer::tokenize(result);
+    functions = Lexer::functions(tokens);
+    size_t n = 0;
+    visitSites(tokens, functions, {exit}, loops, [&](const Lexer::TFunction& function, const std::string& kind, size_t i) {
+        if (n < _sites.size()) _sites[n++].line = kind == "FUNCTION" ? tokens[function.start].line : tokens[i].line;
+    });
+    
+    return result;
+}
+
+void Instrumenter::locate(const std::string& source, const std::string& filename) {
+    std::vector<std::string> lines;
+    std::istringstream iss(source);
+    for (std::string line; std::getline(iss, line);) lines.push_back(line);
+    
+    static const std::regex identifier(R"(^\w+$)");
+    long header = -1;
+    std::unordered_map<std::string, int> ordinals;
+    
+    for (auto& site : _sites) {
+        long found = -1;
+        
+        if (site.kind == "FUNCTION") {
+            header = -1;
+            ordinals.clear();
+            if (std::regex_match(site.function, identifier)) {
+                std::regex re("^\\s*(?:EXPORT\\s+)?" + site.function + "\\s*\\([^;]*$", std::regex::icase);
+                for (size_t i = 0; i < lines.size(); i++) {
+                    if (!std::regex_search(lines[i], re)) continue;
+                    header = found = static_cast<long>(i);
+                    break;
+                }
+            }
+        } else if (header >= 0) {
+            // The nth loop of its kind in the function, counting from its header.
+            int nth = ++ordinals[site.kind];
+            std::regex re("\\b" + site.kind + "\\b", std::regex::icase);
+            for (size_t i = header; i < lines.size() && found < 0; i++) {
+                for (auto it = std::sregex_iterator(lines[i].begin(), lines[i].end(), re); it != std::sregex_iterator(); ++it) {
+                    if (--nth == 0) {
+                        found = static_cast<long>(i);
+                        break;
+                    }
+                }
+            }
+        }
+        
+        site.location = found >= 0 ? filename + ":" + std::to_string(found + 1) : "(generated):" + std::to_string(site.line);
+    }
+}
+
+bool Instrumenter::saveSites(const std::filesystem::path& path) const {
+    std::ofstream os(path);
+    if (!os.is_open()) return false;
+    
+    os << "# " << _list << "\n";
+    for (const auto& site : _sites) {
+        os << site.kind << "\t" << site.function << "\t" << site.location << "\n";
+    }
+    return true;
+}
+
+bool Instrumenter::report(const std::filesystem::path& sitesPath, const std::filesystem::path& dumpPath, std::ostream& os) {
+    std::ifstream is(sitesPath);
+    if (!is.is_open()) {
+        std::cerr << "❌ Unable to open file " << sitesPath.filename() << ".\n";
+        return false;
+    }
+    
+    std::vector<TSite> sites;
+    for (std::string line; std::getline(is, line);) {
+        if (line.empty() || line.front() == '#') continue;
+        std::istringstream fields(line);
+        TSite site = {};
+        std::getline(fields, site.kind, '\t');
+        std::getline(fields, site.function, '\t');
+        std::getline(fields, site.location);
+        sites.push_back(site);
+    }
+    
+    std::ifstream dump(dumpPath);
+    if (!dump.is_open()) {
+        std::cerr << "❌ Unable to open file " << dumpPath.filename() << ".\n";
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(dump)), std::istreambuf_iterator<char>());
+    for (const std::string& from : {std::string("ᴇ"), std::string("−")}) {
+        for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos)) {
+            text.replace(pos, from.size(), from == "ᴇ" ? "e" : "-");
+        }
+    }
+    
+    std::vector<double> values;
+    static const std::regex number(R"(-?\d+(?:\.\d*)?(?:[eE][-+]?\d+)?)");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), number); it != std::sregex_iterator(); ++it) {
+        values.push_back(std::stod(it->str()));
+    }
+    if (values.size() != sites.size() * 2) {
+        std::cerr << "❌ error: " << dumpPath.filename() << " has " << values.size() << " values, " << sites.size() * 2 << " expected.\n";
+        return false;
+    }
+    
+    typedef struct {
+        const TSite* site;
+        double calls;
+        double ms;
+    } TRow;
+    
+    std::vector<TRow> rows;
+    double total = 0;
+    size_t idle = 0;
+    for (size_t i = 0; i < sites.size(); i++) {
+        TRow row = {&sites[i], values[i * 2], values[i * 2 + 1]};
+        if (row.calls == 0) {
+            idle++;
+            continue;
+        }
+        if (row.site->kind == "FUNCTION") total = std::max(total, row.ms);
+        rows.push_back(row);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const TRow& a, const TRow& b) {
+        return a.ms > b.ms;
+    });
+    
+    os << std::right << std::setw(12) << "Time (ms)" << std::setw(8) << "%" << std::setw(10) << "Calls" << std::setw(12) << "Avg (ms)" << "  Site\n";
+    for (const auto& row : rows) {
+        os << std::fixed << std::setprecision(0) << std::setw(12) << row.ms
+        << std::setprecision(1) << std::setw(8) << (total > 0 ? row.ms * 100 / total : 0)
+        << std::setprecision(0) << std::setw(10) << row.calls
+        << std::setprecision(3) << std::setw(12) << row.ms / row.calls
+        << "  " << row.site->kind << " " << row.site->function << "  " << row.site->location << "\n";
+    }
+    if (idle) os << idle << " site(s) never ran\n";
+    return true;
+}
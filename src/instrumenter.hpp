@@ -0,0 +1,82 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INSTRUMENTER_HPP
+#define INSTRUMENTER_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+
+namespace pplplus {
+    /*
+     Adds timers to a program so that where it spends its time can be measured on the
+     calculator itself.
+     
+     Each function, and with loops each FOR, WHILE and REPEAT, is a site with two entries
+     in an exported global list: the number of times it ran and the milliseconds, by
+     TICKS, it took, including any functions it called. A RETURN from within a loop ends
+     the function's timing but not the loop's.
+     
+     The sites are saved to a side table, which report reads back along with the list as
+     copied from the calculator, and prints with the file and line of each site.
+     */
+    class Instrumenter {
+    public:
+        typedef struct TSite {
+            std::string function;
+            std::string kind;       // FUNCTION, FOR, WHILE or REPEAT.
+            long line;              // In the generated code.
+            std::string location;   // file:line in the source, once located.
+        } TSite;
+        
+        bool loops = false;
+        
+        std::string instrument(const std::string& code);
+        
+        // Finds each site in the source it was translated from, falling back to its generated line.
+        void locate(const std::string& source, const std::string& filename);
+        
+        // Name of the exported list holding the counts and times.
+        const std::string& list(void) const {
+            return _list;
+        }
+        
+        const std::vector<TSite>& sites(void) const {
+            return _sites;
+        }
+        
+        bool saveSites(const std::filesystem::path& path) const;
+        
+        // Prints the sites of the side table, busiest first, with the times dumped from the calculator.
+        static bool report(const std::filesystem::path& sites, const std::filesystem::path& dump, std::ostream& os);
+        
+    private:
+        std::string _list;
+        std::vector<TSite> _sites;
+    };
+}
+
+#endif // INSTRUMENTER_HPP
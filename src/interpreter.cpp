@@ -0,0 +1,1527 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "interpreter.hpp"
+#include "lexer.hpp"
+
+#include <cmath>
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+using pplplus::Interpreter;
+using pplplus::Lexer;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+typedef std::chrono::steady_clock Clock;
+
+// MARK: - Values
+
+namespace {
+    struct Value {
+        enum class Type { Real, Integer, String, List } type = Type::Real;
+        double real = 0;
+        long long integer = 0;
+        std::string string;
+        std::vector<Value> list;
+        
+        static Value number(double real) {
+            Value value;
+            value.real = real;
+            return value;
+        }
+        
+        static Value whole(long long integer) {
+            Value value;
+            value.type = Type::Integer;
+            value.integer = integer;
+            return value;
+        }
+        
+        static Value text(const std::string& string) {
+            Value value;
+            value.type = Type::String;
+            value.string = string;
+            return value;
+        }
+        
+        static Value items(std::vector<Value> list) {
+            Value value;
+            value.type = Type::List;
+            value.list = std::move(list);
+            return value;
+        }
+        
+        bool isNumber(void) const {
+            return type == Type::Real || type == Type::Integer;
+        }
+        
+        double toReal(void) const {
+            return type == Type::Integer ? static_cast<double>(integer) : real;
+        }
+        
+        long long toInteger(void) const {
+            return type == Type::Integer ? integer : static_cast<long long>(real);
+        }
+    };
+    
+    struct RuntimeError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+    
+    std::string format(const Value& value, bool quoted = true) {
+        std::ostringstream os;
+        switch (value.type) {
+            case Value::Type::Real:
+                os << std::setprecision(12) << value.real;
+                break;
+            case Value::Type::Integer:
+                if (value.integer < 0) os << "-";
+                os << "#" << std::uppercase << std::hex << (value.integer < 0 ? -value.integer : value.integer) << ":64h";
+                break;
+            case Value::Type::String:
+                if (quoted) os << "\"" << value.string << "\"";
+                else os << value.string;
+                break;
+            case Value::Type::List:
+                os << "{";
+                for (size_t i = 0; i < value.list.size(); i++) os << (i ? "," : "") << format(value.list[i]);
+                os << "}";
+                break;
+        }
+        return os.str();
+    }
+}
+
+// MARK: - Syntax Tree
+
+namespace {
+    enum class Kind {
+        Number, String, List, Name, Call, Index, Unary, Binary, And, Or,
+        Block, Local, Assign, If, For, While, Repeat, Case, Return, Break, Continue, Statement, IfErr
+    };
+    
+    struct Node;
+    typedef std::unique_ptr<Node> NodePtr;
+    
+    /*
+     The children of each kind of node are:
+     
+     List: the items, Call: the arguments, Index: the indexed expression then the
+     positions, Unary: the operand, Binary, And and Or: the two operands, Block: the statements, Local: an initial value or null for each of
+     names, Assign: the target then the value, If: the condition, THEN and ELSE blocks,
+     For: from, to, step or null and the body, While: the condition and body, Repeat: the
+     body and condition, Case: a condition and block for each IF then any DEFAULT block,
+     Return: the value if any, Statement: the expression, IfErr: the blocks.
+     */
+    struct Node {
+        Kind kind;
+        long line = 0;
+        std::string name;
+        Value value;
+        bool down = false;
+        std::vector<std::string> names;
+        std::vector<NodePtr> children;
+        
+        Node(Kind kind, long line) : kind(kind), line(line) {}
+    };
+    
+    struct Function {
+        std::string name;
+        std::vector<std::string> params;
+        NodePtr body;
+        size_t index;
+    };
+    
+    // MARK: - Parser
+    
+    class Parser {
+    public:
+        std::unordered_map<std::string, Function> functions;
+        std::vector<std::pair<std::string, NodePtr>> globals;
+        
+        explicit Parser(const std::string& code) {
+            for (auto& token : Lexer::tokenize(code)) {
+                if (token.type != Type::Directive) _tokens.push_back(std::move(token));
+            }
+        }
+        
+        void program(void) {
+            while (_i < _tokens.size()) {
+                if (accept(";") || accept("EXPORT") || accept("KEY") || accept("CONST")) continue;
+                if (accept("VIEW")) {
+                    if (peek().type == Type::String) _i++;
+                    expect(",");
+                    continue;
+                }
+                if (accept("LOCAL")) {
+                    declarations();
+                    continue;
+                }
+                
+                const TToken& token = peek();
+                if (token.type != Type::Identifier) fail("unexpected '" + token.text + "'");
+                
+                if (_i + 1 < _tokens.size() && Lexer::is(_tokens[_i + 1], Type::Operator, "(")) {
+                    function();
+                    continue;
+                }
+                declarations();
+            }
+        }
+        
+        NodePtr call(void) {
+            NodePtr node = expression();
+            if (_i < _tokens.size()) fail("unexpected '" + peek().text + "'");
+            return node;
+        }
+        
+    private:
+        std::vector<TToken> _tokens;
+        size_t _i = 0;
+        
+        [[noreturn]] void fail(const std::string& message) {
+            long line = _i < _tokens.size() ? _tokens[_i].line : (_tokens.empty() ? 0 : _tokens.back().line);
+            throw RuntimeError("line " + std::to_string(line) + ": " + message);
+        }
+        
+        const TToken& peek(void) {
+            if (_i >= _tokens.size()) fail("unexpected end of program");
+            return _tokens[_i];
+        }
+        
+        long line(void) {
+            return _i < _tokens.size() ? _tokens[_i].line : 0;
+        }
+        
+        bool at(std::string_view text) {
+            return _i < _tokens.size() && _tokens[_i].type != Type::String && _tokens[_i].text == text;
+        }
+        
+        bool accept(std::string_view text) {
+            if (!at(text)) return false;
+            _i++;
+            return true;
+        }
+        
+        void expect(std::string_view text) {
+            if (!accept(text)) fail("expected '" + std::string(text) + "'" + (_i < _tokens.size() ? " before '" + _tokens[_i].text + "'" : ""));
+        }
+        
+        std::string identifier(void) {
+            const TToken& token = peek();
+            if (token.type != Type::Identifier) fail("expected a name before '" + token.text + "'");
+            _i++;
+            return token.text;
+        }
+        
+        // MARK: Declarations
+        
+        void declarations(void) {
+            do {
+                std::string name = identifier();
+                NodePtr value = accept(":=") ? expression() : nullptr;
+                globals.emplace_back(name, std::move(value));
+            } while (accept(","));
+            accept(";");
+        }
+        
+        void function(void) {
+            Function function;
+            function.name = identifier();
+            expect("(");
+            while (!accept(")")) {
+                function.params.push_back(identifier());
+                accept(",");
+            }
+            
+            // A forward declaration.
+            if (accept(";")) return;
+            
+            expect("BEGIN");
+            function.body = block({"END"});
+            expect("END");
+            accept(";");
+            
+            function.index = functions.size();
+            auto it = functions.find(function.name);
+            if (it != functions.end()) function.index = it->second.index;
+            functions[function.name] = std::move(function);
+        }
+        
+        // MARK: Statements
+        
+        NodePtr block(std::initializer_list<std::string_view> ends) {
+            auto node = std::make_unique<Node>(Kind::Block, line());
+            while (true) {
+                if (accept(";")) continue;
+                bool end = false;
+                for (auto word : ends) end = end || at(word);
+                if (end) break;
+                node->children.push_back(statement());
+                
+                // Otherwise a statement that stops short would quietly become two.
+                end = accept(";");
+                for (auto word : ends) end = end || at(word);
+                if (!end) expect(";");
+            }
+            return node;
+        }
+        
+        NodePtr statement(void) {
+            long at = line();
+            
+            if (accept("LOCAL")) {
+                accept("CONST");
+                auto node = std::make_unique<Node>(Kind::Local, at);
+                do {
+                    node->names.push_back(identifier());
+                    node->children.push_back(accept(":=") ? expression() : nullptr);
+                } while (accept(","));
+                return node;
+            }
+            
+            if (accept("IF")) {
+                auto node = std::make_unique<Node>(Kind::If, at);
+                node->children.push_back(expression());
+                expect("THEN");
+                node->children.push_back(block({"ELSE", "END"}));
+                if (accept("ELSE")) node->children.push_back(block({"END"}));
+                expect("END");
+                return node;
+            }
+            
+            if (accept("FOR")) {
+                auto node = std::make_unique<Node>(Kind::For, at);
+                node->name = identifier();
+                if (!accept(":=")) expect("FROM");
+                node->children.push_back(expression());
+                if (accept("DOWNTO")) node->down = true;
+                else expect("TO");
+                node->children.push_back(expression());
+                node->children.push_back(accept("STEP") ? expression() : nullptr);
+                expect("DO");
+                node->children.push_back(block({"END"}));
+                expect("END");
+                return node;
+            }
+            
+            if (accept("WHILE")) {
+                auto node = std::make_unique<Node>(Kind::While, at);
+                node->children.push_back(expression());
+                expect("DO");
+                node->children.push_back(block({"END"}));
+                expect("END");
+                return node;
+            }
+            
+            if (accept("REPEAT")) {
+                auto node = std::make_unique<Node>(Kind::Repeat, at);
+                node->children.push_back(block({"UNTIL"}));
+                expect("UNTIL");
+                node->children.push_back(expression());
+                return node;
+            }
+            
+            if (accept("CASE")) {
+                auto node = std::make_unique<Node>(Kind::Case, at);
+                while (true) {
+                    if (accept(";")) continue;
+                    if (accept("IF")) {
+                        node->children.push_back(expression());
+                        expect("THEN");
+                        node->children.push_back(block({"END"}));
+                        expect("END");
+                        continue;
+                    }
+                    if (accept("DEFAULT")) {
+                        node->children.push_back(block({"END"}));
+                    }
+                    break;
+                }
+                expect("END");
+                return node;
+            }
+            
+            if (accept("IFERR")) {
+                auto node = std::make_unique<Node>(Kind::IfErr, at);
+                node->children.push_back(block({"THEN"}));
+                expect("THEN");
+                node->children.push_back(block({"ELSE", "END"}));
+                if (accept("ELSE")) node->children.push_back(block({"END"}));
+                expect("END");
+                return node;
+            }
+            
+            if (accept("RETURN")) {
+                auto node = std::make_unique<Node>(Kind::Return, at);
+                if (!this->at(";") && !this->at("END") && !this->at("ELSE") && !this->at("UNTIL")) node->children.push_back(expression());
+                return node;
+            }
+            
+            if (accept("BREAK")) {
+                auto node = std::make_unique<Node>(Kind::Break, at);
+                node->value.real = _i < _tokens.size() && _tokens[_i].type == Type::Number ? std::stod(_tokens[_i++].text) : 1;
+                return node;
+            }
+            
+            if (accept("CONTINUE")) {
+                return std::make_unique<Node>(Kind::Continue, at);
+            }
+            
+            NodePtr value = expression();
+            if (accept(":=")) {
+                auto node = std::make_unique<Node>(Kind::Assign, at);
+                if (value->kind != Kind::Name && value->kind != Kind::Call && value->kind != Kind::Index) fail("cannot assign to this");
+                node->children.push_back(std::move(value));
+                node->children.push_back(expression());
+                return node;
+            }
+            if (accept("▶")) {
+                auto node = std::make_unique<Node>(Kind::Assign, at);
+                NodePtr target = postfix();
+                if (target->kind != Kind::Name && target->kind != Kind::Call && target->kind != Kind::Index) fail("cannot assign to this");
+                node->children.push_back(std::move(target));
+                node->children.push_back(std::move(value));
+                return node;
+            }
+            
+            auto node = std::make_unique<Node>(Kind::Statement, at);
+            node->children.push_back(std::move(value));
+            return node;
+        }
+        
+        // MARK: Expressions
+        
+        NodePtr binary(Kind kind, const std::string& op, NodePtr a, NodePtr b) {
+            auto node = std::make_unique<Node>(kind, a->line);
+            node->name = op;
+            node->children.push_back(std::move(a));
+            node->children.push_back(std::move(b));
+            return node;
+        }
+        
+        NodePtr expression(void) {
+            NodePtr node = conjunction();
+            while (true) {
+                if (accept("OR")) node = binary(Kind::Or, "OR", std::move(node), conjunction());
+                else if (accept("XOR")) node = binary(Kind::Binary, "XOR", std::move(node), conjunction());
+                else return node;
+            }
+        }
+        
+        NodePtr conjunction(void) {
+            NodePtr node = negation();
+            while (accept("AND")) node = binary(Kind::And, "AND", std::move(node), negation());
+            return node;
+        }
+        
+        NodePtr negation(void) {
+            long at = line();
+            if (accept("NOT")) {
+                auto node = std::make_unique<Node>(Kind::Unary, at);
+                node->name = "NOT";
+                node->children.push_back(negation());
+                return node;
+            }
+            return relation();
+        }
+        
+        NodePtr relation(void) {
+            static const std::unordered_map<std::string, std::string> operators = {
+                {"==", "=="}, {"=", "=="}, {"≠", "≠"}, {"<>", "≠"}, {"!=", "≠"},
+                {"<", "<"}, {">", ">"}, {"≤", "≤"}, {"<=", "≤"}, {"≥", "≥"}, {">=", "≥"}
+            };
+            NodePtr node = sum();
+            while (_i < _tokens.size() && _tokens[_i].type == Type::Operator && operators.count(_tokens[_i].text)) {
+                std::string op = operators.at(_tokens[_i++].text);
+                node = binary(Kind::Binary, op, std::move(node), sum());
+            }
+            return node;
+        }
+        
+        NodePtr sum(void) {
+            NodePtr node = product();
+            while (true) {
+                if (accept("+")) node = binary(Kind::Binary, "+", std::move(node), product());
+                else if (accept("-") || accept("−")) node = binary(Kind::Binary, "-", std::move(node), product());
+                else return node;
+            }
+        }
+        
+        NodePtr product(void) {
+            NodePtr node = unary();
+            while (true) {
+                if (accept("*") || accept("×")) node = binary(Kind::Binary, "*", std::move(node), unary());
+                else if (accept("/") || accept("÷")) node = binary(Kind::Binary, "/", std::move(node), unary());
+                else if (accept("MOD")) node = binary(Kind::Binary, "MOD", std::move(node), unary());
+                else if (accept("DIV")) node = binary(Kind::Binary, "DIV", std::move(node), unary());
+                else return node;
+            }
+        }
+        
+        NodePtr unary(void) {
+            long at = line();
+            if (accept("-") || accept("−")) {
+                auto node = std::make_unique<Node>(Kind::Unary, at);
+                node->name = "-";
+                node->children.push_back(unary());
+                return node;
+            }
+            if (accept("+")) return unary();
+            return power();
+        }
+        
+        NodePtr power(void) {
+            NodePtr node = postfix();
+            if (accept("^")) node = binary(Kind::Binary, "^", std::move(node), unary());
+            return node;
+        }
+        
+        NodePtr postfix(void) {
+            const TToken& token = peek();
+            long at = token.line;
+            
+            if (token.type == Type::Number) {
+                _i++;
+                auto node = std::make_unique<Node>(Kind::Number, at);
+                node->value = number(token.text);
+                return node;
+            }
+            
+            if (token.type == Type::String) {
+                _i++;
+                if (token.text.front() != '"') fail("only \"strings\" are supported, not " + token.text);
+                std::string s = token.text.substr(1, token.text.size() - 2);
+                for (size_t pos = s.find("\\\""); pos != std::string::npos; pos = s.find("\\\"", pos + 1)) s.replace(pos, 2, "\"");
+                for (size_t pos = s.find("\\n"); pos != std::string::npos; pos = s.find("\\n", pos + 1)) s.replace(pos, 2, "\n");
+                auto node = std::make_unique<Node>(Kind::String, at);
+                node->value = Value::text(s);
+                return node;
+            }
+            
+            if (accept("(")) {
+                NodePtr node = expression();
+                expect(")");
+                return node;
+            }
+            
+            if (accept("{")) {
+                auto node = std::make_unique<Node>(Kind::List, at);
+                while (!accept("}")) {
+                    node->children.push_back(expression());
+                    if (!this->at("}")) expect(",");
+                }
+                return node;
+            }
+            
+            if (token.type != Type::Identifier || Lexer::isKeyword(token.text)) fail("unexpected '" + token.text + "'");
+            std::string name = identifier();
+            
+            if (name == "π") {
+                auto node = std::make_unique<Node>(Kind::Number, at);
+                node->value = Value::number(M_PI);
+                return node;
+            }
+            
+            // B→R, R→B and the like.
+            while (this->at("→") && _i + 1 < _tokens.size() && _tokens[_i + 1].type == Type::Identifier) {
+                name += "→" + _tokens[_i + 1].text;
+                _i += 2;
+            }
+            
+            NodePtr node = std::make_unique<Node>(Kind::Name, at);
+            node->name = name;
+            if (accept("(")) {
+                node->kind = Kind::Call;
+                arguments(*node, ")");
+            }
+            
+            // L(1)(2) and L[1][2] index the result of what comes before.
+            while (this->at("(") || this->at("[")) {
+                std::string close = accept("(") ? ")" : (_i++, "]");
+                auto index = std::make_unique<Node>(Kind::Index, at);
+                index->children.push_back(std::move(node));
+                arguments(*index, close);
+                if (index->children.size() == 1) fail("expected a position");
+                node = std::move(index);
+            }
+            return node;
+        }
+        
+        void arguments(Node& node, const std::string& close) {
+            while (!accept(close)) {
+                node.children.push_back(expression());
+                if (!this->at(close)) expect(",");
+            }
+        }
+        
+        Value number(const std::string& text) {
+            if (text.front() == '#') {
+                std::string digits = text.substr(1);
+                int base = 16;
+                size_t colon = digits.find(':');
+                char suffix = digits.back();
+                if (colon != std::string::npos) digits.resize(colon);
+                else if (std::string("hbodHBOD").find(suffix) != std::string::npos && digits.size() > 1) digits.pop_back();
+                else suffix = 'h';
+                switch (std::tolower(suffix)) {
+                    case 'b': base = 2; break;
+                    case 'o': base = 8; break;
+                    case 'd': base = 10; break;
+                    default: base = 16; break;
+                }
+                try {
+                    return Value::whole(static_cast<long long>(std::stoull(digits, nullptr, base)));
+                } catch (...) {
+                    fail("'" + text + "' is not an integer");
+                }
+            }
+            
+            std::string s = text;
+            for (const std::string& from : {std::string("ᴇ"), std::string("−")}) {
+                for (size_t pos = s.find(from); pos != std::string::npos; pos = s.find(from, pos)) s.replace(pos, from.size(), from == "ᴇ" ? "e" : "-");
+            }
+            try {
+                return Value::number(std::stod(s));
+            } catch (...) {
+                fail("'" + text + "' is not a number");
+            }
+        }
+    };
+}
+
+// MARK: - Machine
+
+namespace {
+    enum class Flow { Next, Break, Continue, Return };
+    
+    // Stops the program, unlike a RuntimeError which IFERR can catch.
+    struct Abort : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+    
+    struct Frame {
+        std::unordered_map<std::string, Value> variables;
+        Value last;
+    };
+    
+    // The most calls in progress at once, well within the stack of the interpreter itself.
+    const size_t DEPTH_LIMIT = 2000;
+    
+    const std::unordered_set<std::string> graphics = {
+        "RECT", "RECT_P", "LINE", "LINE_P", "PIXON", "PIXON_P", "PIXOFF", "PIXOFF_P",
+        "TEXTOUT", "TEXTOUT_P", "BLIT", "BLIT_P", "DIMGROB", "DIMGROB_P", "SUBGROB", "SUBGROB_P",
+        "FILLPOLY", "FILLPOLY_P", "ARC", "ARC_P", "INVERT", "INVERT_P", "TRIANGLE", "TRIANGLE_P",
+        "GETPIX", "GETPIX_P", "GROBW", "GROBW_P", "GROBH", "GROBH_P", "FREEZE", "DRAWMENU",
+        "STARTVIEW", "WAIT"
+    };
+    
+    const std::unordered_map<std::string, double (*)(double)> maths = {
+        {"SIN", [](double x) { return std::sin(x); }},
+        {"COS", [](double x) { return std::cos(x); }},
+        {"TAN", [](double x) { return std::tan(x); }},
+        {"ASIN", [](double x) { return std::asin(x); }},
+        {"ACOS", [](double x) { return std::acos(x); }},
+        {"ATAN", [](double x) { return std::atan(x); }},
+        {"SINH", [](double x) { return std::sinh(x); }},
+        {"COSH", [](double x) { return std::cosh(x); }},
+        {"TANH", [](double x) { return std::tanh(x); }},
+        {"ASINH", [](double x) { return std::asinh(x); }},
+        {"ACOSH", [](double x) { return std::acosh(x); }},
+        {"ATANH", [](double x) { return std::atanh(x); }},
+        {"LN", [](double x) { return std::log(x); }},
+        {"LOG", [](double x) { return std::log10(x); }},
+        {"EXP", [](double x) { return std::exp(x); }},
+        {"ALOG", [](double x) { return std::pow(10.0, x); }},
+        {"SQRT", [](double x) { return std::sqrt(x); }},
+        {"√", [](double x) { return std::sqrt(x); }},
+        {"IP", [](double x) { return std::trunc(x); }},
+        {"FP", [](double x) { return x - std::trunc(x); }},
+        {"FLOOR", [](double x) { return std::floor(x); }},
+        {"CEILING", [](double x) { return std::ceil(x); }},
+        {"SIGN", [](double x) { return static_cast<double>((x > 0) - (x < 0)); }}
+    };
+    
+    // Built-ins are not case sensitive, so sqrt and SQRT are one function.
+    std::string uppercased(std::string name) {
+        for (char& c : name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return name;
+    }
+}
+
+class Interpreter::Machine {
+public:
+    std::unordered_map<std::string, Function> functions;
+    std::unordered_map<std::string, Value> globals;
+    std::vector<NodePtr> nodes;
+    std::vector<TStats> stats;
+    size_t count = 0;
+    size_t limit = 0;
+    
+    Machine() {
+        for (char c = 'A'; c <= 'Z'; c++) globals[std::string(1, c)] = Value::number(0);
+        for (char c = '0'; c <= '9'; c++) globals[std::string("G") + c] = Value::whole(0);
+    }
+    
+    Value evaluate(const Node& node) {
+        return eval(node);
+    }
+    
+private:
+    std::vector<Frame> _frames;
+    std::vector<size_t> _current;
+    std::vector<int> _depth;
+    std::vector<Clock::time_point> _started;
+    Value _returned;
+    int _breaks = 0;
+    std::mt19937 _random{0};
+    Clock::time_point _epoch = Clock::now();
+    
+    [[noreturn]] static void fail(const Node& node, const std::string& message) {
+        throw RuntimeError("line " + std::to_string(node.line) + ": " + message);
+    }
+    
+    void tick(const Node& node) {
+        if (++count > limit) throw Abort("line " + std::to_string(node.line) + ": stopped after " + std::to_string(limit) + " instructions");
+        if (!_current.empty()) stats[_current.back()].instructions++;
+    }
+    
+    Value* lookup(const std::string& name) {
+        if (!_frames.empty()) {
+            auto it = _frames.back().variables.find(name);
+            if (it != _frames.back().variables.end()) return &it->second;
+        }
+        auto it = globals.find(name);
+        return it == globals.end() ? nullptr : &it->second;
+    }
+    
+    std::unordered_map<std::string, Value>& scope(void) {
+        return _frames.empty() ? globals : _frames.back().variables;
+    }
+    
+    static bool truth(const Node& node, const Value& value) {
+        if (!value.isNumber()) fail(node, "expected a number, not " + format(value));
+        return value.toReal() != 0;
+    }
+    
+    static double real(const Node& node, const Value& value) {
+        if (!value.isNumber()) fail(node, "expected a number, not " + format(value));
+        return value.toReal();
+    }
+    
+    static bool equal(const Value& a, const Value& b) {
+        if (a.isNumber() && b.isNumber()) return a.toReal() == b.toReal();
+        if (a.type != b.type) return false;
+        if (a.type == Value::Type::String) return a.string == b.string;
+        if (a.list.size() != b.list.size()) return false;
+        for (size_t i = 0; i < a.list.size(); i++) {
+            if (!equal(a.list[i], b.list[i])) return false;
+        }
+        return true;
+    }
+    
+    // MARK: Expressions
+    
+    Value eval(const Node& node) {
+        tick(node);
+        switch (node.kind) {
+            case Kind::Number:
+            case Kind::String:
+                return node.value;
+                
+            case Kind::List: {
+                std::vector<Value> items;
+                items.reserve(node.children.size());
+                for (const auto& child : node.children) items.push_back(eval(*child));
+                return Value::items(std::move(items));
+            }
+                
+            case Kind::Name:
+                return name(node);
+                
+            case Kind::Call:
+                return call(node);
+                
+            case Kind::Index: {
+                Value value = eval(*node.children[0]);
+                for (size_t i = 1; i < node.children.size(); i++) value = index(node, value, eval(*node.children[i]));
+                return value;
+            }
+                
+            case Kind::Unary: {
+                Value value = eval(*node.children[0]);
+                if (node.name == "NOT") return Value::number(truth(node, value) ? 0 : 1);
+                return negate(node, value);
+            }
+                
+            case Kind::And:
+                return Value::number(truth(node, eval(*node.children[0])) && truth(node, eval(*node.children[1])) ? 1 : 0);
+                
+            case Kind::Or:
+                return Value::number(truth(node, eval(*node.children[0])) || truth(node, eval(*node.children[1])) ? 1 : 0);
+                
+            case Kind::Binary: {
+                Value a = eval(*node.children[0]);
+                return arithmetic(node, node.name, a, eval(*node.children[1]));
+            }
+                
+            default:
+                fail(node, "not an expression");
+        }
+    }
+    
+    Value negate(const Node& node, const Value& value) {
+        switch (value.type) {
+            case Value::Type::Real: return Value::number(-value.real);
+            case Value::Type::Integer: return Value::whole(-value.integer);
+            case Value::Type::List: {
+                std::vector<Value> items;
+                for (const auto& item : value.list) items.push_back(negate(node, item));
+                return Value::items(std::move(items));
+            }
+            default: fail(node, "cannot negate " + format(value));
+        }
+    }
+    
+    Value arithmetic(const Node& node, const std::string& op, const Value& a, const Value& b) {
+        bool relational = op == "==" || op == "≠" || op == "<" || op == ">" || op == "≤" || op == "≥";
+        
+        if (a.type == Value::Type::List || b.type == Value::Type::List) {
+            if (op == "==" || op == "≠") return Value::number(equal(a, b) == (op == "==") ? 1 : 0);
+            
+            std::vector<Value> items;
+            if (a.type == Value::Type::List && b.type == Value::Type::List) {
+                if (a.list.size() != b.list.size()) fail(node, "lists of different sizes");
+                for (size_t i = 0; i < a.list.size(); i++) items.push_back(arithmetic(node, op, a.list[i], b.list[i]));
+            } else if (a.type == Value::Type::List) {
+                for (const auto& item : a.list) items.push_back(arithmetic(node, op, item, b));
+            } else {
+                for (const auto& item : b.list) items.push_back(arithmetic(node, op, a, item));
+            }
+            return Value::items(std::move(items));
+        }
+        
+        if (a.type == Value::Type::String || b.type == Value::Type::String) {
+            if (op == "+") return Value::text(format(a, false) + format(b, false));
+            if (op == "==" || op == "≠") return Value::number(equal(a, b) == (op == "==") ? 1 : 0);
+            if (relational && a.type == b.type) {
+                int c = a.string.compare(b.string);
+                return Value::number((op == "<" ? c < 0 : op == ">" ? c > 0 : op == "≤" ? c <= 0 : c >= 0) ? 1 : 0);
+            }
+            fail(node, "cannot use " + op + " with " + format(a) + " and " + format(b));
+        }
+        
+        if (a.type == Value::Type::Integer && b.type == Value::Type::Integer) {
+            long long x = a.integer, y = b.integer;
+            if (op == "+") return Value::whole(x + y);
+            if (op == "-") return Value::whole(x - y);
+            if (op == "*") return Value::whole(x * y);
+            if (op == "/" || op == "DIV" || op == "MOD") {
+                if (y == 0) fail(node, "division by zero");
+                if (op != "MOD") return Value::whole(x / y);
+                long long r = x % y;
+                if (r != 0 && (r < 0) != (y < 0)) r += y;
+                return Value::whole(r);
+            }
+            if (op == "^") return Value::whole(static_cast<long long>(std::llround(std::pow(static_cast<double>(x), static_cast<double>(y)))));
+        }
+        
+        double x = a.toReal(), y = b.toReal();
+        if (op == "+") return Value::number(x + y);
+        if (op == "-") return Value::number(x - y);
+        if (op == "*") return Value::number(x * y);
+        if (op == "/" || op == "DIV" || op == "MOD") {
+            if (y == 0) fail(node, "division by zero");
+            if (op == "/") return Value::number(x / y);
+            if (op == "DIV") return Value::number(std::trunc(x / y));
+            return Value::number(x - y * std::floor(x / y));
+        }
+        if (op == "^") return Value::number(std::pow(x, y));
+        if (op == "==") return Value::number(x == y ? 1 : 0);
+        if (op == "≠") return Value::number(x != y ? 1 : 0);
+        if (op == "<") return Value::number(x < y ? 1 : 0);
+        if (op == ">") return Value::number(x > y ? 1 : 0);
+        if (op == "≤") return Value::number(x <= y ? 1 : 0);
+        if (op == "≥") return Value::number(x >= y ? 1 : 0);
+        if (op == "XOR") return Value::number((x != 0) != (y != 0) ? 1 : 0);
+        fail(node, "unknown operator " + op);
+    }
+    
+    Value index(const Node& node, const Value& container, const Value& position) {
+        long long i = static_cast<long long>(real(node, position));
+        if (container.type == Value::Type::List) {
+            if (i < 1 || i > static_cast<long long>(container.list.size())) fail(node, "index " + std::to_string(i) + " out of range");
+            return container.list[i - 1];
+        }
+        if (container.type == Value::Type::String) {
+            if (i < 1 || i > static_cast<long long>(container.string.size())) fail(node, "index " + std::to_string(i) + " out of range");
+            return Value::number(static_cast<unsigned char>(container.string[i - 1]));
+        }
+        fail(node, "cannot index " + format(container));
+    }
+    
+    Value name(const Node& node) {
+        if (Value* value = lookup(node.name)) return *value;
+        
+        auto it = functions.find(node.name);
+        if (it != functions.end()) return invoke(node, it->second, {});
+        
+        if (node.name == "e") return Value::number(M_E);
+        
+        std::vector<Value> none;
+        Value result;
+        if (builtin(node, uppercased(node.name), none, result)) return result;
+        fail(node, "unknown name " + node.name);
+    }
+    
+    Value call(const Node& node) {
+        if (lookup(node.name)) {
+            std::vector<Value> positions;
+            for (const auto& child : node.children) positions.push_back(eval(*child));
+            Value value = *lookup(node.name);
+            for (const auto& position : positions) value = index(node, value, position);
+            return value;
+        }
+        
+        const std::string upper = uppercased(node.name);
+        if (upper == "IFTE" && node.children.size() == 3) {
+            return truth(node, eval(*node.children[0])) ? eval(*node.children[1]) : eval(*node.children[2]);
+        }
+        if (upper == "MAKELIST") return makelist(node);
+        
+        std::vector<Value> args;
+        args.reserve(node.children.size());
+        for (const auto& child : node.children) args.push_back(eval(*child));
+        
+        auto it = functions.find(node.name);
+        if (it != functions.end()) return invoke(node, it->second, std::move(args));
+        
+        Value result;
+        if (builtin(node, upper, args, result)) return result;
+        fail(node, "unknown function " + node.name);
+    }
+    
+    // MAKELIST(expression, variable, start, end[, step]) evaluates the expression for each value.
+    Value makelist(const Node& node) {
+        if (node.children.size() < 4 || node.children[1]->kind != Kind::Name) fail(node, "MAKELIST(expression, variable, start, end[, step]) expected");
+        double from = real(node, eval(*node.children[2]));
+        double to = real(node, eval(*node.children[3]));
+        double step = node.children.size() > 4 ? real(node, eval(*node.children[4])) : 1;
+        if (step == 0) fail(node, "MAKELIST step of 0");
+        
+        const std::string& variable = node.children[1]->name;
+        if (!lookup(variable)) scope()[variable] = Value::number(0);
+        
+        std::vector<Value> items;
+        for (double x = from; step > 0 ? x <= to : x >= to; x += step) {
+            *lookup(variable) = Value::number(x);
+            items.push_back(eval(*node.children[0]));
+        }
+        return Value::items(std::move(items));
+    }
+    
+    Value invoke(const Node& node, const Function& function, std::vector<Value> args) {
+        if (args.size() != function.params.size()) {
+            fail(node, function.name + " takes " + std::to_string(function.params.size()) + " argument(s), not " + std::to_string(args.size()));
+        }
+        if (_frames.size() >= DEPTH_LIMIT) fail(node, "calls nested too deeply");
+        
+        TStats& stat = stats[function.index];
+        stat.calls++;
+        if (_depth.size() < stats.size()) {
+            _depth.resize(stats.size(), 0);
+            _started.resize(stats.size());
+        }
+        if (_depth[function.index]++ == 0) _started[function.index] = Clock::now();
+        
+        _frames.emplace_back();
+        for (size_t i = 0; i < args.size(); i++) _frames.back().variables[function.params[i]] = std::move(args[i]);
+        _current.push_back(function.index);
+        
+        auto finish = [&]() {
+            _current.pop_back();
+            _frames.pop_back();
+            if (--_depth[function.index] == 0) {
+                stat.milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - _started[function.index]).count();
+            }
+        };
+        
+        Value result;
+        try {
+            Flow flow = exec(*function.body);
+            result = flow == Flow::Return ? std::move(_returned) : std::move(_frames.back().last);
+        } catch (...) {
+            finish();
+            throw;
+        }
+        finish();
+        return result;
+    }
+    
+    // MARK: Statements
+    
+    void assign(const Node& target, Value value) {
+        if (target.kind == Kind::Name) {
+            Value* variable = lookup(target.name);
+            if (!variable) fail(target, "unknown variable " + target.name);
+            *variable = std::move(value);
+            return;
+        }
+        
+        std::vector<long long> positions;
+        const Node& root = element(target, positions);
+        
+        Value* ref = lookup(root.name);
+        if (!ref) fail(target, "unknown variable " + root.name);
+        for (size_t n = 0; n < positions.size(); n++) {
+            long long i = positions[n];
+            if (ref->type != Value::Type::List) fail(target, root.name + " is not a list");
+            if (n + 1 == positions.size() && i == static_cast<long long>(ref->list.size()) + 1) {
+                ref->list.push_back(std::move(value));
+                return;
+            }
+            if (i < 1 || i > static_cast<long long>(ref->list.size())) fail(target, "index " + std::to_string(i) + " out of range");
+            ref = &ref->list[i - 1];
+        }
+        *ref = std::move(value);
+    }
+    
+    // The variable an element assignment writes to, adding the positions of L(i, j), L(i)(j) or L[i][j].
+    const Node& element(const Node& target, std::vector<long long>& positions) {
+        size_t first = 0;
+        const Node* root = &target;
+        if (target.kind == Kind::Index) {
+            root = &element(*target.children[0], positions);
+            first = 1;
+        } else if (target.kind != Kind::Call && target.kind != Kind::Name) {
+            fail(target, "cannot assign to this");
+        }
+        for (size_t i = first; i < target.children.size(); i++) positions.push_back(static_cast<long long>(real(target, eval(*target.children[i]))));
+        return *root;
+    }
+    
+    // Handles a loop body's Break or Continue, true if the loop should stop.
+    bool stops(Flow flow, Flow& result) {
+        if (flow == Flow::Return) {
+            result = Flow::Return;
+            return true;
+        }
+        if (flow == Flow::Break) {
+            result = --_breaks > 0 ? Flow::Break : Flow::Next;
+            return true;
+        }
+        return false;
+    }
+    
+    Flow exec(const Node& node) {
+        if (node.kind == Kind::Block) {
+            for (const auto& child : node.children) {
+                Flow flow = exec(*child);
+                if (flow != Flow::Next) return flow;
+            }
+            return Flow::Next;
+        }
+        
+        tick(node);
+        Flow result = Flow::Next;
+        
+        switch (node.kind) {
+            case Kind::Local:
+                for (size_t i = 0; i < node.names.size(); i++) {
+                    scope()[node.names[i]] = node.children[i] ? eval(*node.children[i]) : Value::number(0);
+                }
+                return Flow::Next;
+                
+            case Kind::Assign: {
+                Value value = eval(*node.children[1]);
+                if (!_frames.empty()) _frames.back().last = value;
+                assign(*node.children[0], std::move(value));
+                return Flow::Next;
+            }
+                
+            case Kind::Statement: {
+                Value value = eval(*node.children[0]);
+                if (!_frames.empty()) _frames.back().last = std::move(value);
+                return Flow::Next;
+            }
+                
+            case Kind::If:
+                if (truth(node, eval(*node.children[0]))) return exec(*node.children[1]);
+                if (node.children.size() > 2) return exec(*node.children[2]);
+                return Flow::Next;
+                
+            case Kind::For: {
+                if (!lookup(node.name)) fail(node, "unknown variable " + node.name);
+                double from = real(node, eval(*node.children[0]));
+                double to = real(node, eval(*node.children[1]));
+                double step = node.children[2] ? real(node, eval(*node.children[2])) : 1;
+                if (node.down) step = -step;
+                
+                *lookup(node.name) = Value::number(from);
+                while (true) {
+                    double x = real(node, *lookup(node.name));
+                    if (node.down ? x < to : x > to) break;
+                    if (stops(exec(*node.children[3]), result)) return result;
+                    *lookup(node.name) = Value::number(real(node, *lookup(node.name)) + step);
+                    tick(node);
+                }
+                return Flow::Next;
+            }
+                
+            case Kind::While:
+                while (truth(node, eval(*node.children[0]))) {
+                    if (stops(exec(*node.children[1]), result)) return result;
+                }
+                return Flow::Next;
+                
+            case Kind::Repeat:
+                do {
+                    if (stops(exec(*node.children[0]), result)) return result;
+                } while (!truth(node, eval(*node.children[1])));
+                return Flow::Next;
+                
+            case Kind::Case:
+                for (size_t i = 0; i + 1 < node.children.size(); i += 2) {
+                    if (truth(node, eval(*node.children[i]))) return exec(*node.children[i + 1]);
+                }
+                if (node.children.size() % 2) return exec(*node.children.back());
+                return Flow::Next;
+                
+            case Kind::Return:
+                _returned = node.children.empty() ? Value::number(0) : eval(*node.children[0]);
+                return Flow::Return;
+                
+            case Kind::Break:
+                _breaks = std::max(1, static_cast<int>(node.value.real));
+                return Flow::Break;
+                
+            case Kind::Continue:
+                return Flow::Continue;
+                
+            case Kind::IfErr: {
+                size_t frames = _frames.size();
+                Flow flow;
+                try {
+                    flow = exec(*node.children[0]);
+                } catch (const RuntimeError&) {
+                    _frames.resize(frames);
+                    return exec(*node.children[1]);
+                }
+                if (flow != Flow::Next || node.children.size() < 3) return flow;
+                return exec(*node.children[2]);
+            }
+                
+            default:
+                fail(node, "not a statement");
+        }
+    }
+    
+    // MARK: Built-ins
+    
+    static long long integer(const Node& node, const Value& value) {
+        if (!value.isNumber()) fail(node, "expected a number, not " + format(value));
+        return value.toInteger();
+    }
+    
+    static const std::string& string(const Node& node, const Value& value) {
+        if (value.type != Value::Type::String) fail(node, "expected a string, not " + format(value));
+        return value.string;
+    }
+    
+    static const std::vector<Value>& list(const Node& node, const Value& value) {
+        if (value.type != Value::Type::List) fail(node, "expected a list, not " + format(value));
+        return value.list;
+    }
+    
+    // Keeps the integer type of like when given one.
+    static Value like(const Value& like, long long value) {
+        return like.type == Value::Type::Integer ? Value::whole(value) : Value::number(static_cast<double>(value));
+    }
+    
+    Value map(const Node& node, double (*f)(double), const Value& value) {
+        if (value.type == Value::Type::List) {
+            std::vector<Value> items;
+            for (const auto& item : value.list) items.push_back(map(node, f, item));
+            return Value::items(std::move(items));
+        }
+        return Value::number(f(real(node, value)));
+    }
+    
+    bool builtin(const Node& node, const std::string& name, std::vector<Value>& args, Value& result) {
+        size_t n = args.size();
+        auto arity = [&](size_t low, size_t high) {
+            if (n < low || n > high) fail(node, name + " takes " + (low == high ? std::to_string(low) : std::to_string(low) + " to " + std::to_string(high)) + " argument(s)");
+        };
+        
+        auto math = maths.find(name);
+        if (math != maths.end()) {
+            arity(1, 1);
+            result = map(node, math->second, args[0]);
+            return true;
+        }
+        
+        if (graphics.count(name)) {
+            result = Value::number(0);
+            return true;
+        }
+        
+        if (name == "ABS") {
+            arity(1, 1);
+            if (args[0].type == Value::Type::Integer) result = Value::whole(std::llabs(args[0].integer));
+            else result = map(node, [](double x) { return std::fabs(x); }, args[0]);
+            return true;
+        }
+        
+        if (name == "ROUND" || name == "TRUNCATE") {
+            arity(1, 2);
+            double scale = std::pow(10.0, n > 1 ? real(node, args[1]) : 0);
+            double x = real(node, args[0]) * scale;
+            result = Value::number((name == "ROUND" ? std::round(x) : std::trunc(x)) / scale);
+            return true;
+        }
+        
+        if (name == "MIN" || name == "MAX") {
+            const std::vector<Value>& values = n == 1 && args[0].type == Value::Type::List ? args[0].list : args;
+            if (values.empty()) fail(node, name + " of nothing");
+            result = values[0];
+            for (const auto& value : values) {
+                bool smaller = real(node, value) < real(node, result);
+                if (name == "MIN" ? smaller : real(node, value) > real(node, result)) result = value;
+            }
+            return true;
+        }
+        
+        if (name == "SIZE" || name == "DIM") {
+            arity(1, 1);
+            if (args[0].type == Value::Type::String) result = Value::number(static_cast<double>(args[0].string.size()));
+            else result = Value::number(static_cast<double>(list(node, args[0]).size()));
+            return true;
+        }
+        
+        if (name == "ΣLIST" || name == "ΠLIST") {
+            arity(1, 1);
+            bool sum = name == "ΣLIST";
+            result = Value::number(sum ? 0 : 1);
+            for (const auto& item : list(node, args[0])) result = arithmetic(node, sum ? "+" : "*", result, item);
+            return true;
+        }
+        
+        if (name == "CONCAT") {
+            arity(2, 2);
+            if (args[0].type == Value::Type::String && args[1].type == Value::Type::String) {
+                result = Value::text(args[0].string + args[1].string);
+                return true;
+            }
+            std::vector<Value> items = args[0].type == Value::Type::List ? args[0].list : std::vector<Value>{args[0]};
+            if (args[1].type == Value::Type::List) items.insert(items.end(), args[1].list.begin(), args[1].list.end());
+            else items.push_back(args[1]);
+            result = Value::items(std::move(items));
+            return true;
+        }
+        
+        if (name == "REVERSE") {
+            arity(1, 1);
+            std::vector<Value> items = list(node, args[0]);
+            std::reverse(items.begin(), items.end());
+            result = Value::items(std::move(items));
+            return true;
+        }
+        
+        if (name == "SORT") {
+            arity(1, 1);
+            std::vector<Value> items = list(node, args[0]);
+            std::stable_sort(items.begin(), items.end(), [&](const Value& a, const Value& b) {
+                if (a.type == Value::Type::String && b.type == Value::Type::String) return a.string < b.string;
+                return real(node, a) < real(node, b);
+            });
+            result = Value::items(std::move(items));
+            return true;
+        }
+        
+        if (name == "POS") {
+            arity(2, 2);
+            const auto& items = list(node, args[0]);
+            result = Value::number(0);
+            for (size_t i = 0; i < items.size(); i++) {
+                if (equal(items[i], args[1])) {
+                    result = Value::number(static_cast<double>(i + 1));
+                    break;
+                }
+            }
+            return true;
+        }
+        
+        if (name == "SUB" || name == "MID" || name == "LEFT" || name == "RIGHT") {
+            if (name == "SUB") arity(3, 3);
+            else if (name == "MID") arity(2, 3);
+            else arity(2, 2);
+            
+            size_t size = args[0].type == Value::Type::String ? args[0].string.size() : list(node, args[0]).size();
+            long long first = 1, last = static_cast<long long>(size);
+            if (name == "SUB") {
+                first = integer(node, args[1]);
+                last = integer(node, args[2]);
+            } else if (name == "MID") {
+                first = integer(node, args[1]);
+                if (n > 2) last = first + integer(node, args[2]) - 1;
+            } else if (name == "LEFT") {
+                last = integer(node, args[1]);
+            } else {
+                first = static_cast<long long>(size) - integer(node, args[1]) + 1;
+            }
+            first = std::max(first, 1LL);
+            last = std::min(last, static_cast<long long>(size));
+            
+            if (args[0].type == Value::Type::String) {
+                result = Value::text(first <= last ? args[0].string.substr(first - 1, last - first + 1) : "");
+            } else {
+                std::vector<Value> items;
+                for (long long i = first; i <= last; i++) items.push_back(args[0].list[i - 1]);
+                result = Value::items(std::move(items));
+            }
+            return true;
+        }
+        
+        if (name == "INSTRING") {
+            arity(2, 2);
+            size_t pos = string(node, args[0]).find(string(node, args[1]));
+            result = Value::number(pos == std::string::npos ? 0 : static_cast<double>(pos + 1));
+            return true;
+        }
+        
+        if (name == "UPPER" || name == "LOWER") {
+            arity(1, 1);
+            std::string s = string(node, args[0]);
+            for (char& c : s) c = static_cast<char>(name == "UPPER" ? std::toupper(static_cast<unsigned char>(c)) : std::tolower(static_cast<unsigned char>(c)));
+            result = Value::text(s);
+            return true;
+        }
+        
+        if (name == "STRING") {
+            arity(1, 1);
+            result = Value::text(format(args[0], false));
+            return true;
+        }
+        
+        if (name == "CHAR") {
+            arity(1, 1);
+            std::string s;
+            auto append = [&](const Value& code) { s += static_cast<char>(integer(node, code)); };
+            if (args[0].type == Value::Type::List) for (const auto& code : args[0].list) append(code);
+            else append(args[0]);
+            result = Value::text(s);
+            return true;
+        }
+        
+        if (name == "ASC") {
+            arity(1, 1);
+            std::vector<Value> items;
+            for (unsigned char c : string(node, args[0])) items.push_back(Value::number(c));
+            result = Value::items(std::move(items));
+            return true;
+        }
+        
+        if (name == "TYPE") {
+            arity(1, 1);
+            static const double types[] = {0, 1, 2, 6};
+            result = Value::number(types[static_cast<int>(args[0].type)]);
+            return true;
+        }
+        
+        if (name == "TICKS") {
+            result = Value::number(std::floor(std::chrono::duration<double, std::milli>(Clock::now() - _epoch).count()));
+            return true;
+        }
+        
+        if (name == "RANDOM" || name == "RANDINT") {
+            double low = 0, high = name == "RANDOM" ? 1 : 100;
+            if (n == 1) high = real(node, args[0]);
+            if (n >= 2) {
+                low = real(node, args[0]);
+                high = real(node, args[1]);
+            }
+            if (name == "RANDOM") {
+                result = Value::number(std::uniform_real_distribution<double>(low, high)(_random));
+            } else {
+                result = Value::number(static_cast<double>(std::uniform_int_distribution<long long>(static_cast<long long>(low), static_cast<long long>(high))(_random)));
+            }
+            return true;
+        }
+        
+        if (name == "RANDSEED") {
+            arity(1, 1);
+            _random.seed(static_cast<unsigned>(integer(node, args[0])));
+            result = Value::number(0);
+            return true;
+        }
+        
+        if (name == "BITAND" || name == "BITOR" || name == "BITXOR") {
+            if (n < 2) fail(node, name + " takes at least 2 arguments");
+            long long value = integer(node, args[0]);
+            for (size_t i = 1; i < n; i++) {
+                long long other = integer(node, args[i]);
+                value = name == "BITAND" ? value & other : name == "BITOR" ? value | other : value ^ other;
+            }
+            result = like(args[0], value);
+            return true;
+        }
+        
+        if (name == "BITNOT") {
+            arity(1, 1);
+            result = like(args[0], ~integer(node, args[0]));
+            return true;
+        }
+        
+        if (name == "BITSL" || name == "BITSR") {
+            arity(1, 2);
+            long long shift = n > 1 ? integer(node, args[1]) : 1;
+            unsigned long long value = static_cast<unsigned long long>(integer(node, args[0]));
+            if (shift >= 64) value = 0;
+            else value = name == "BITSL" ? value << shift : value >> shift;
+            result = like(args[0], static_cast<long long>(value));
+            return true;
+        }
+        
+        if (name == "R→B") {
+            arity(1, 1);
+            result = Value::whole(integer(node, args[0]));
+            return true;
+        }
+        
+        if (name == "B→R") {
+            arity(1, 1);
+            result = Value::number(static_cast<double>(integer(node, args[0])));
+            return true;
+        }
+        
+        if (name == "PRINT" || name == "MSGBOX") {
+            if (n) std::cout << format(args[0], false) << "\n";
+            result = Value::number(0);
+            return true;
+        }
+        
+        if (name == "GETKEY") {
+            result = Value::number(-1);
+            return true;
+        }
+        
+        if (name == "ISKEYDOWN") {
+            result = Value::number(0);
+            return true;
+        }
+        
+        return false;
+    }
+};
+
+// MARK: - Interpreter
+
+Interpreter::Interpreter() = default;
+Interpreter::~Interpreter() = default;
+
+bool Interpreter::load(const std::string& code) {
+    _error.clear();
+    _machine = std::make_unique<Machine>();
+    _machine->limit = limit;
+    
+    try {
+        Parser parser(code);
+        parser.program();
+        
+        _machine->functions = std::move(parser.functions);
+        _machine->stats.resize(_machine->functions.size());
+        for (const auto& [name, function] : _machine->functions) {
+            _machine->stats[function.index] = {name, 0, 0, 0};
+        }
+        
+        for (auto& [name, value] : parser.globals) {
+            _machine->globals[name] = value ? _machine->evaluate(*value) : Value::number(0);
+            if (value) _machine->nodes.push_back(std::move(value));
+        }
+    } catch (const std::exception& e) {
+        _error = e.what();
+        return false;
+    }
+    return true;
+}
+
+bool Interpreter::run(const std::string& call, std::string& result) {
+    _error.clear();
+    if (!_machine) {
+        _error = "no program loaded";
+        return false;
+    }
+    
+    try {
+        Parser parser(call);
+        _machine->nodes.push_back(parser.call());
+        result = format(_machine->evaluate(*_machine->nodes.back()));
+    } catch (const std::exception& e) {
+        _error = e.what();
+        return false;
+    }
+    return true;
+}
+
+size_t Interpreter::instructions(void) const {
+    return _machine ? _machine->count : 0;
+}
+
+std::vector<Interpreter::TStats> Interpreter::stats(void) const {
+    std::vector<TStats> stats;
+    if (!_machine) return stats;
+    
+    for (const auto& stat : _machine->stats) {
+        if (stat.calls) stats.push_back(stat);
+    }
+    std::stable_sort(stats.begin(), stats.end(), [](const TStats& a, const TStats& b) {
+        return a.instructions > b.instructions;
+    });
+    return stats;
+}
+
+void Interpreter::report(std::ostream& os) const {
+    size_t width = 8;
+    auto stats = this->stats();
+    for (const auto& stat : stats) width = std::max(width, stat.function.size());
+    
+    os << std::left << std::setw(static_cast<int>(width)) << "Function" << std::right
+    << std::setw(12) << "Calls" << std::setw(16) << "Instructions" << std::setw(14) << "Time (ms)" << "\n";
+    for (const auto& stat : stats) {
+        os << std::left << std::setw(static_cast<int>(width)) << stat.function << std::right
+        << std::setw(12) << stat.calls << std::setw(16) << stat.instructions
+        << std::setw(14) << std::fixed << std::setprecision(3) << stat.milliseconds << "\n";
+    }
+    os << instructions() << " instruction(s) in total\n";
+}
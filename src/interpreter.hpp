@@ -0,0 +1,86 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INTERPRETER_HPP
+#define INTERPRETER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+
+namespace pplplus {
+    /*
+     Runs programs in the subset of PPL that the translator emits, so that generated code
+     can be measured without a calculator, such as to compare the passes or --compress.
+     
+     Reals, 64-bit integers, strings and lists are supported, with locals and globals,
+     IF, FOR, WHILE, REPEAT, CASE and IFERR, functions and the common built-ins. Drawing
+     commands such as RECT_P and TEXTOUT_P do nothing, and GETKEY reports no key. PRINT
+     writes to standard output.
+     
+     For each function it counts the calls, the instructions run within it, each being a
+     statement or an operation of an expression, and the time taken including the
+     functions it called.
+     */
+    class Interpreter {
+    public:
+        typedef struct TStats {
+            std::string function;
+            size_t calls;
+            size_t instructions;
+            double milliseconds;
+        } TStats;
+        
+        // Instructions to run before giving up, in case the program never ends.
+        size_t limit = 1000000000;
+        
+        Interpreter();
+        ~Interpreter();
+        
+        // Reads the functions and globals of the program, false with error set if it cannot.
+        bool load(const std::string& code);
+        
+        // Calls a function, such as Main or Main(10), false with error set if it fails.
+        bool run(const std::string& call, std::string& result);
+        
+        const std::string& error(void) const {
+            return _error;
+        }
+        
+        size_t instructions(void) const;
+        
+        // Functions that were called, most instructions first.
+        std::vector<TStats> stats(void) const;
+        
+        void report(std::ostream& os) const;
+        
+    private:
+        class Machine;
+        std::unique_ptr<Machine> _machine;
+        std::string _error;
+    };
+}
+
+#endif // INTERPRETER_HPP
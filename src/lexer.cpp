@@ -0,0 +1,558 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lexer.hpp"
+
+#include <unordered_set>
+#include <algorithm>
+#include <cctype>
+
+using pplplus::Lexer;
+
+// MARK: - Character Classes
+
+// Decodes the UTF-8 sequence at pos, returning the code point and its length in bytes.
+static char32_t codePoint(std::string_view str, size_t pos, size_t& length) {
+    unsigned char c = str[pos];
+    
+    length = 1;
+    if (c < 0x80) return c;
+    
+    if ((c & 0xE0) == 0xC0) length = 2;
+    else if ((c & 0xF0) == 0xE0) length = 3;
+    else if ((c & 0xF8) == 0xF0) length = 4;
+    
+    if (pos + length > str.size()) {
+        length = 1;
+        return c;
+    }
+    
+    char32_t code = c & (0xFF >> (length + 1));
+    for (size_t i = 1; i < length; i++) {
+        code = (code << 6) | (str[pos + i] & 0x3F);
+    }
+    return code;
+}
+
+/*
+ Letters that may appear in names, ASCII as well as the accented Latin, Greek and
+ Cyrillic letters the HP Prime allows, as in ΣLIST or θ. Other symbols such as ≥,
+ ▶ or √ are operators.
+ */
+static bool isNameCharacter(char32_t code, bool first) {
+    if (code < 0x80) {
+        return std::isalpha(static_cast<int>(code)) || code == '_' || (!first && std::isdigit(static_cast<int>(code)));
+    }
+    if (code == 0x00D7 || code == 0x00F7) return false; // × ÷
+    return (code >= 0x00C0 && code <= 0x024F) || (code >= 0x0370 && code <= 0x03FF) || (code >= 0x0400 && code <= 0x04FF);
+}
+
+static bool startsWithCaseInsensitive(std::string_view str, std::string_view prefix) {
+    if (str.size() < prefix.size()) return false;
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(str[i])) != std::tolower(static_cast<unsigned char>(prefix[i]))) return false;
+    }
+    return true;
+}
+
+// MARK: - Scanning
+
+// Length of a preprocessor line or embedded #PYTHON/#CAS block starting at pos, or 0.
+static size_t directiveLength(std::string_view code, size_t pos) {
+    std::string_view s = code.substr(pos + 1);
+    size_t eol = code.find('\n', pos);
+    if (eol == std::string_view::npos) eol = code.size();
+    
+    if (startsWithCaseInsensitive(s, "pragma")) return eol - pos;
+    
+    if (!startsWithCaseInsensitive(s, "python") && !startsWithCaseInsensitive(s, "cas")) return 0;
+    
+    // The block runs up to and including the line starting with #END.
+    while (eol < code.size()) {
+        size_t start = eol + 1;
+        size_t first = code.find_first_not_of(" \t", start);
+        eol = code.find('\n', start);
+        if (eol == std::string_view::npos) eol = code.size();
+        if (first != std::string_view::npos && first < eol && startsWithCaseInsensitive(code.substr(first), "#end")) break;
+    }
+    return eol - pos;
+}
+
+// Zero when the quote is never closed, it is then taken as a lone operator.
+static size_t quotedLength(std::string_view code, size_t pos) {
+    char quote = code[pos];
+    size_t i = pos + 1;
+    
+    while (i < code.size() && code[i] != quote) {
+        // Only double-quoted strings have escapes.
+        if (quote == '"' && code[i] == '\\' && i + 1 < code.size()) i++;
+        i++;
+    }
+    return i < code.size() ? i + 1 - pos : 0;
+}
+
+static size_t numberLength(std::string_view code, size_t pos) {
+    size_t i = pos;
+    
+    if (code[i] == '#') {
+        // Integer such as #FFh or #FF:32h
+        i++;
+        while (i < code.size() && std::isalnum(static_cast<unsigned char>(code[i]))) i++;
+        if (i + 1 < code.size() && code[i] == ':' && std::isdigit(static_cast<unsigned char>(code[i + 1]))) {
+            i++;
+            while (i < code.size() && std::isalnum(static_cast<unsigned char>(code[i]))) i++;
+        }
+        return i - pos;
+    }
+    
+    while (i < code.size() && std::isdigit(static_cast<unsigned char>(code[i]))) i++;
+    if (i < code.size() && code[i] == '.') {
+        i++;
+        while (i < code.size() && std::isdigit(static_cast<unsigned char>(code[i]))) i++;
+    }
+    
+    // Exponent, E or the small ᴇ used by the HP Prime.
+    size_t e = 0;
+    if (i < code.size() && (code[i] == 'E' || code[i] == 'e')) e = 1;
+    if (code.substr(i).starts_with("ᴇ")) e = std::string_view("ᴇ").size();
+    if (e) {
+        size_t j = i + e;
+        if (j < code.size() && (code[j] == '+' || code[j] == '-')) j++;
+        else if (code.substr(j).starts_with("−")) j += std::string_view("−").size();
+        if (j < code.size() && std::isdigit(static_cast<unsigned char>(code[j]))) {
+            i = j;
+            while (i < code.size() && std::isdigit(static_cast<unsigned char>(code[i]))) i++;
+        }
+    }
+    
+    return i - pos;
+}
+
+std::vector<Lexer::TToken> Lexer::tokenize(std::string_view code, bool comments) {
+    static const std::string_view operators[] = {":=", "==", "<=", ">=", "<>", "!=", "->"};
+    
+    std::vector<TToken> tokens;
+    TToken token;
+    bool lineStart = true;
+    long line = 1;
+    size_t i = 0;
+    
+    auto emit = [&](Type type, size_t length) {
+        token.type = type;
+        token.text = std::string(code.substr(i, length));
+        token.line = line;
+        token.offset = i;
+        for (size_t n = i; n < i + length; n++) {
+            if (code[n] == '\n') line++;
+        }
+        tokens.push_back(token);
+        token = TToken();
+        lineStart = false;
+        i += length;
+    };
+    
+    while (i < code.size()) {
+        char c = code[i];
+        
+        if (c == '\n') {
+            token.newline = true;
+            token.space = true;
+            lineStart = true;
+            line++;
+            i++;
+            continue;
+        }
+        
+        if (c == ' ' || c == '\t' || c == '\r') {
+            token.space = true;
+            i++;
+            continue;
+        }
+        
+        if (c == '#' && lineStart) {
+            size_t length = directiveLength(code, i);
+            if (length) {
+                emit(Type::Directive, length);
+                continue;
+            }
+        }
+        
+        if (c == '/' && i + 1 < code.size() && code[i + 1] == '/') {
+            size_t eol = code.find('\n', i);
+            size_t length = (eol == std::string_view::npos ? code.size() : eol) - i;
+            if (comments) {
+                emit(Type::Comment, length);
+            } else {
+                i += length;
+                token.space = true;
+            }
+            continue;
+        }
+        
+        if (c == '"' || c == '\'' || c == '`') {
+            size_t length = quotedLength(code, i);
+            if (length) {
+                emit(Type::String, length);
+                continue;
+            }
+        }
+        
+        if (std::isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && i + 1 < code.size() && std::isdigit(static_cast<unsigned char>(code[i + 1]))) ||
+            (c == '#' && i + 1 < code.size() && std::isalnum(static_cast<unsigned char>(code[i + 1])))) {
+            emit(Type::Number, numberLength(code, i));
+            continue;
+        }
+        
+        size_t length;
+        char32_t character = codePoint(code, i, length);
+        
+        if (isNameCharacter(character, true)) {
+            size_t j = i + length;
+            while (j < code.size()) {
+                char32_t next = codePoint(code, j, length);
+                if (!isNameCharacter(next, false)) break;
+                j += length;
+            }
+            emit(Type::Identifier, j - i);
+            continue;
+        }
+        
+        bool found = false;
+        for (std::string_view op : operators) {
+            if (code.substr(i).starts_with(op)) {
+                emit(Type::Operator, op.size());
+                found = true;
+                break;
+            }
+        }
+        if (!found) emit(Type::Operator, length);
+    }
+    
+    return tokens;
+}
+
+// MARK: - Editing
+
+std::string Lexer::apply(std::string_view code, std::vector<TEdit> edits) {
+    std::stable_sort(edits.begin(), edits.end(), [](const TEdit& a, const TEdit& b) {
+        return a.offset < b.offset;
+    });
+    
+    std::string result;
+    result.reserve(code.size());
+    
+    size_t pos = 0;
+    for (const TEdit& edit : edits) {
+        if (edit.offset < pos || edit.offset + edit.length > code.size()) continue;
+        result += code.substr(pos, edit.offset - pos);
+        result += edit.text;
+        pos = edit.offset + edit.length;
+    }
+    result += code.substr(pos);
+    
+    return result;
+}
+
+Lexer::TEdit Lexer::erase(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last) {
+    size_t start = tokens[first].offset;
+    size_t end = tokens[last].offset + tokens[last].text.size();
+    
+    size_t lineStart = start;
+    while (lineStart > 0 && (code[lineStart - 1] == ' ' || code[lineStart - 1] == '\t')) lineStart--;
+    
+    size_t lineEnd = end;
+    while (lineEnd < code.size() && (code[lineEnd] == ' ' || code[lineEnd] == '\t' || code[lineEnd] == '\r')) lineEnd++;
+    
+    if ((lineStart == 0 || code[lineStart - 1] == '\n') && (lineEnd == code.size() || code[lineEnd] == '\n')) {
+        start = lineStart;
+        end = lineEnd < code.size() ? lineEnd + 1 : lineEnd;
+    }
+    
+    return {start, end - start, ""};
+}
+
+bool pplplus::Edits::add(const Lexer::TEdit& edit) {
+    size_t end = edit.offset + edit.length;
+    
+    auto next = _ranges.lower_bound(edit.offset);
+    if (next != _ranges.end() && (next->first < end || next->first == edit.offset)) return false;
+    if (next != _ranges.begin() && std::prev(next)->second > edit.offset) return false;
+    
+    _ranges[edit.offset] = end;
+    _edits.push_back(edit);
+    return true;
+}
+
+std::string_view Lexer::text(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last) {
+    size_t start = tokens[first].offset;
+    return code.substr(start, tokens[last].offset + tokens[last].text.size() - start);
+}
+
+// MARK: - Structure
+
+bool Lexer::isKeyword(const std::string& str) {
+    static const std::unordered_set<std::string> keywords = {
+        "BEGIN", "END", "RETURN", "LOCAL", "EXPORT", "KEY", "VIEW", "CONST",
+        "IF", "THEN", "ELSE", "IFERR", "CASE", "DEFAULT",
+        "FOR", "FROM", "TO", "DOWNTO", "STEP", "DO", "WHILE", "REPEAT", "UNTIL",
+        "BREAK", "CONTINUE",
+        "AND", "OR", "NOT", "XOR", "MOD", "DIV"
+    };
+    return keywords.contains(str);
+}
+
+size_t Lexer::pureCall(const std::vector<TToken>& tokens, size_t i, bool ignoreCase) {
+    static const std::unordered_set<std::string> builtins = {
+        "SIZE", "DIM", "ABS", "MIN", "MAX", "FLOOR", "CEILING", "IP", "FP", "ROUND", "TRUNCATE", "SIGN",
+        "SQ", "SQRT", "EXP", "LN", "LOG", "SIN", "COS", "TAN", "ASIN", "ACOS", "ATAN", "SINH", "COSH", "TANH",
+        "BITAND", "BITOR", "BITXOR", "BITNOT", "BITSL", "BITSR", "RGB", "LEFT", "RIGHT", "MID", "UPPER", "LOWER",
+        "CHAR", "ASC", "INSTRING", "POS", "ΣLIST", "ΠLIST"
+    };
+    
+    auto name = [&](size_t j) {
+        std::string text = tokens[j].text;
+        if (ignoreCase) std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::toupper(c); });
+        return text;
+    };
+    
+    if (i + 1 >= tokens.size() || tokens[i].type != Type::Identifier) return 0;
+    if (i > 0 && is(tokens[i - 1], Type::Operator, ".")) return 0;
+    if (builtins.contains(name(i)) && is(tokens[i + 1], Type::Operator, "(")) return 1;
+    
+    // B→R and R→B
+    if (i + 3 < tokens.size() && is(tokens[i + 1], Type::Operator, "→") && is(tokens[i + 3], Type::Operator, "(") &&
+        tokens[i + 2].type == Type::Identifier &&
+        ((name(i) == "B" && name(i + 2) == "R") || (name(i) == "R" && name(i + 2) == "B"))) {
+        return 3;
+    }
+    return 0;
+}
+
+bool Lexer::is(const TToken& token, Type type, std::string_view text) {
+    return token.type == type && token.text == text;
+}
+
+bool Lexer::isIdentifier(const TToken& token, std::string_view text) {
+    return is(token, Type::Identifier, text);
+}
+
+bool Lexer::isOperator(const TToken& token, std::string_view text) {
+    return is(token, Type::Operator, text);
+}
+
+bool Lexer::isOpening(const TToken& token) {
+    return token.type == Type::Operator && (token.text == "(" || token.text == "[" || token.text == "{");
+}
+
+bool Lexer::isClosing(const TToken& token) {
+    return token.type == Type::Operator && (token.text == ")" || token.text == "]" || token.text == "}");
+}
+
+bool Lexer::isName(const TToken& token) {
+    return token.type == Type::Identifier && !isKeyword(token.text) && token.text != "π";
+}
+
+bool Lexer::isOperand(const TToken& token) {
+    return token.type == Type::Number || token.type == Type::String || isClosing(token) ||
+    (token.type == Type::Identifier && !isKeyword(token.text));
+}
+
+bool Lexer::isStatementStart(const std::vector<TToken>& tokens, size_t i) {
+    if (i == 0) return true;
+    const TToken& token = tokens[i - 1];
+    if (isOperator(token, ";")) return true;
+    if (token.type != Type::Identifier) return false;
+    return token.text == "BEGIN" || token.text == "THEN" || token.text == "ELSE" || token.text == "DO" ||
+    token.text == "REPEAT" || token.text == "DEFAULT" || token.text == "CASE" || token.text == "IFERR";
+}
+
+size_t Lexer::closing(const std::vector<TToken>& tokens, size_t i, size_t end) {
+    int depth = 0;
+    for (; i < end; i++) {
+        if (isOpening(tokens[i])) depth++;
+        if (isClosing(tokens[i])) depth--;
+        if (depth == 0) return i;
+    }
+    return end;
+}
+
+size_t Lexer::opening(const std::vector<TToken>& tokens, size_t i) {
+    int depth = 0;
+    for (size_t j = i + 1; j-- > 0;) {
+        if (isClosing(tokens[j])) depth++;
+        if (isOpening(tokens[j])) depth--;
+        if (depth == 0) return j;
+    }
+    return i;
+}
+
+std::string Lexer::fresh(const std::string& name, std::unordered_set<std::string>& used) {
+    std::string result = name;
+    for (int n = 2; used.contains(result); n++) result = name + std::to_string(n);
+    used.insert(result);
+    return result;
+}
+
+std::vector<std::string_view> Lexer::words(std::string_view text) {
+    auto isWordCharacter = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || (c & 0x80);
+    };
+    
+    std::vector<std::string_view> words;
+    for (size_t i = 0; i < text.size();) {
+        if (!isWordCharacter(text[i])) {
+            i++;
+            continue;
+        }
+        size_t j = i;
+        while (j < text.size() && isWordCharacter(text[j])) j++;
+        words.push_back(text.substr(i, j - i));
+        i = j;
+    }
+    return words;
+}
+
+/*
+ True if the two tokens would run together, or be read differently, without anything
+ between them. A space that separates a name or number from a following ( or ' is
+ kept, as juxtaposition there may be significant, and so is the one in `- -`.
+ */
+bool Lexer::separated(const TToken& a, const TToken& b) {
+    bool operand = (a.type == Type::Identifier && !isKeyword(a.text)) || a.type == Type::Number || a.text == ")";
+    if (b.space && operand && (b.text == "(" || (b.type == Type::String && b.text.front() == '\''))) return true;
+    
+    if (a.type == Type::Number && b.type == Type::Identifier) return true;
+    if (a.text == "-" && b.text == "-") return true;
+    
+    if (a.type == Type::String || b.type == Type::String) return false;
+    if (a.type != Type::Operator && b.type != Type::Operator) return true;
+    if (a.type != b.type) {
+        // Only a few operators can become part of a name or number.
+        const std::string& op = a.type == Type::Operator ? a.text : b.text;
+        if (op.size() == 1 && op != "." && op != "#") return false;
+    }
+    
+    auto tokens = tokenize(a.text + b.text);
+    return tokens.size() != 2 || tokens[0].text != a.text || tokens[1].text != b.text;
+}
+
+bool Lexer::isBlockStart(const TToken& token) {
+    if (token.type != Type::Identifier) return false;
+    return token.text == "BEGIN" || token.text == "IF" || token.text == "IFERR" ||
+           token.text == "FOR" || token.text == "WHILE" || token.text == "CASE";
+}
+
+size_t Lexer::blockEnd(const std::vector<TToken>& tokens, size_t begin) {
+    int depth = 0;
+    
+    for (size_t i = begin; i < tokens.size(); i++) {
+        if (isBlockStart(tokens[i])) depth++;
+        if (is(tokens[i], Type::Identifier, "END") && --depth == 0) return i;
+    }
+    return tokens.size();
+}
+
+size_t Lexer::statementEnd(const std::vector<TToken>& tokens, size_t i) {
+    if (i >= tokens.size()) return tokens.size();
+    
+    if (isBlockStart(tokens[i])) {
+        size_t end = blockEnd(tokens, i);
+        if (end + 1 < tokens.size() && is(tokens[end + 1], Type::Operator, ";")) end++;
+        return std::min(end, tokens.size() - 1);
+    }
+    
+    size_t j = i;
+    if (is(tokens[i], Type::Identifier, "REPEAT")) {
+        // The UNTIL of this REPEAT, past any nested ones, then its condition.
+        int repeats = 0;
+        for (; j < tokens.size(); j++) {
+            if (is(tokens[j], Type::Identifier, "REPEAT")) repeats++;
+            if (is(tokens[j], Type::Identifier, "UNTIL") && --repeats == 0) break;
+        }
+        j++;
+    }
+    
+    int depth = 0;
+    for (; j < tokens.size(); j++) {
+        const TToken& token = tokens[j];
+        if (token.type == Type::Operator) {
+            if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+            if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+            if (token.text == ";" && depth <= 0) return j;
+            continue;
+        }
+        
+        // A statement left without its ; before the end of the enclosing block.
+        if (j > i && token.type == Type::Identifier && depth <= 0 &&
+            (token.text == "END" || token.text == "ELSE" || token.text == "UNTIL" || token.text == "THEN" || token.text == "DEFAULT")) {
+            return j - 1;
+        }
+    }
+    return tokens.size() - 1;
+}
+
+std::vector<Lexer::TFunction> Lexer::functions(const std::vector<TToken>& tokens) {
+    std::vector<TFunction> functions;
+    
+    for (size_t i = 0; i + 1 < tokens.size(); i++) {
+        const TToken& token = tokens[i];
+        
+        // Code at the top level outside of functions, such as a block of global statements.
+        if (isBlockStart(token)) {
+            i = blockEnd(tokens, i);
+            continue;
+        }
+        
+        if (token.type != Type::Identifier || isKeyword(token.text) || !is(tokens[i + 1], Type::Operator, "(")) continue;
+        
+        // Find the closing ')' of the parameter list.
+        size_t close = i + 1;
+        for (int depth = 0; close < tokens.size(); close++) {
+            if (is(tokens[close], Type::Operator, "(")) depth++;
+            if (is(tokens[close], Type::Operator, ")") && --depth == 0) break;
+        }
+        if (close + 1 >= tokens.size() || !is(tokens[close + 1], Type::Identifier, "BEGIN")) {
+            i = close;
+            continue;
+        }
+        
+        TFunction function;
+        function.name = token.text;
+        function.start = i;
+        function.params = i + 1;
+        function.begin = close + 1;
+        function.end = blockEnd(tokens, function.begin);
+        
+        if (i > 0 && (is(tokens[i - 1], Type::Identifier, "EXPORT") || is(tokens[i - 1], Type::Identifier, "KEY"))) {
+            function.exported = true;
+            function.start = i - 1;
+        }
+        
+        functions.push_back(function);
+        i = function.end;
+    }
+    
+    return functions;
+}
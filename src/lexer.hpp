@@ -0,0 +1,169 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LEXER_HPP
+#define LEXER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_set>
+
+namespace pplplus {
+    /*
+     Splits translated PPL into tokens for the passes that work on the program as a
+     whole rather than a line at a time, such as the minifier.
+     
+     Strings, quoted CAS expressions and `...` blocks are kept whole, as are
+     preprocessor lines such as #pragma and embedded #PYTHON or #CAS blocks, which are
+     returned verbatim as a single Directive token.
+     */
+    class Lexer {
+    public:
+        enum class Type {
+            Identifier,
+            Number,
+            String,
+            Operator,
+            Directive,
+            Comment
+        };
+        
+        typedef struct TToken {
+            Type type;
+            std::string text;
+            bool space = false;     // Whitespace came before the token.
+            bool newline = false;   // A line break came before the token.
+            long line = 1;
+            size_t offset = 0;      // Where the token starts in the code.
+        } TToken;
+        
+        /*
+         A function definition, `[EXPORT] name(params) BEGIN ... END`, given as indices
+         into the token vector it was found in.
+         */
+        typedef struct TFunction {
+            std::string name;
+            bool exported = false;
+            size_t start;           // First token, EXPORT or KEY if present.
+            size_t params;          // The opening '('.
+            size_t begin;           // BEGIN.
+            size_t end;             // The closing END.
+        } TFunction;
+        
+        /*
+         A change to the code the tokens came from, so that passes can rewrite parts of a
+         program while leaving the layout and comments of the rest untouched.
+         */
+        typedef struct TEdit {
+            size_t offset;
+            size_t length;
+            std::string text;
+        } TEdit;
+        
+        static std::vector<TToken> tokenize(std::string_view code, bool comments = false);
+        static std::vector<TFunction> functions(const std::vector<TToken>& tokens);
+        
+        // Index of the END closing the block opened at index begin, or tokens.size().
+        static size_t blockEnd(const std::vector<TToken>& tokens, size_t begin);
+        
+        /*
+         Index of the last token of the statement starting at index i, its ; when it has
+         one. A block such as IF ... END; or REPEAT ... UNTIL ...; counts as one statement.
+         */
+        static size_t statementEnd(const std::vector<TToken>& tokens, size_t i);
+        
+        // Applies the edits, in any order, skipping any that overlap an earlier one.
+        static std::string apply(std::string_view code, std::vector<TEdit> edits);
+        
+        // Removes tokens first to last inclusive, and the lines they are on if nothing else is.
+        static TEdit erase(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last);
+        
+        // The code from token first to last inclusive.
+        static std::string_view text(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last);
+        
+        // Every name-like word within text, such as a function named in a string passed to EXPR.
+        static std::vector<std::string_view> words(std::string_view text);
+        
+        // True if whitespace must be kept between two adjacent tokens.
+        static bool separated(const TToken& a, const TToken& b);
+        
+        static bool isKeyword(const std::string& str);
+        
+        /*
+         Number of tokens naming the built-in called at index i, such as SIZE in SIZE(L)
+         or B→R in B→R(x), if it has no side effects and so may be called fewer times
+         than written, otherwise 0. With ignoreCase, size(L) is taken as SIZE(L) too.
+         */
+        static size_t pureCall(const std::vector<TToken>& tokens, size_t i, bool ignoreCase = false);
+        static bool isBlockStart(const TToken& token);
+        static bool is(const TToken& token, Type type, std::string_view text);
+        static bool isIdentifier(const TToken& token, std::string_view text);
+        static bool isOperator(const TToken& token, std::string_view text);
+        
+        // An opening (, [ or {, and a closing ), ] or }.
+        static bool isOpening(const TToken& token);
+        static bool isClosing(const TToken& token);
+        
+        // A name that is not a keyword or π.
+        static bool isName(const TToken& token);
+        
+        // A value, or the end of one, so that a - after it subtracts rather than negates.
+        static bool isOperand(const TToken& token);
+        
+        // True if a statement may begin at index i, at the start or after a ; or a word such as THEN.
+        static bool isStatementStart(const std::vector<TToken>& tokens, size_t i);
+        
+        // Index of the bracket closing the one at index i, or end if it is not closed before end.
+        static size_t closing(const std::vector<TToken>& tokens, size_t i, size_t end);
+        
+        // Index of the bracket opening the one closed at index i.
+        static size_t opening(const std::vector<TToken>& tokens, size_t i);
+        
+        // name, or name2, name3 and so on if that is used, which is then added to used.
+        static std::string fresh(const std::string& name, std::unordered_set<std::string>& used);
+    };
+    
+    // Edits collected by a pass over a program, none of which overlap.
+    class Edits {
+    public:
+        // False, and the edit is not kept, if it overlaps one already added.
+        bool add(const Lexer::TEdit& edit);
+        
+        bool empty(void) const {
+            return _edits.empty();
+        }
+        
+        std::string apply(std::string_view code) const {
+            return Lexer::apply(code, _edits);
+        }
+        
+    private:
+        std::vector<Lexer::TEdit> _edits;
+        std::map<size_t, size_t> _ranges;
+    };
+}
+
+#endif // LEXER_HPP
@@ -28,6 +28,7 @@
 #include <filesystem>
 
 namespace hpprgm {
-    void create(const std::filesystem::path& path, const std::string& prgm, const std::string& name = "");
+    void create(const std::filesystem::path& path, const std::string& prgm);
     std::wstring prgm(const std::filesystem::path& path);
+    std::string load(const std::filesystem::path& path);
 }
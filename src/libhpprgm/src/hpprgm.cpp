@@ -0,0 +1,368 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2025 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hpprgm.hpp"
+
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#if defined(_WIN32)
+    #include <iterator>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+// Size in bytes of the blocks the UTF-16LE payload is written out in.
+#define BLOCK_SIZE 16384
+
+// MARK: - Helper Functions
+
+/*
+ A read-only view of a whole file, memory-mapped where the platform supports it and
+ read into memory otherwise.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+#if !defined(_WIN32)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open file");
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                _mapping = mapping;
+                _data = static_cast<const uint8_t*>(mapping);
+                _size = st.st_size;
+            }
+        }
+        close(fd);
+
+        if (_mapping) return;
+#endif
+
+        std::ifstream f(path, std::ios::binary);
+        if (!f) throw std::runtime_error("Cannot open file");
+
+        _buffer.assign((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (_mapping) munmap(_mapping, _size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const uint8_t> bytes() const {
+        return {_data, _size};
+    }
+
+private:
+    void* _mapping = nullptr;
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    std::vector<uint8_t> _buffer;
+};
+
+// Returns the i-th little-endian 16-bit word of the container.
+static inline uint16_t word(std::span<const uint8_t> bytes, size_t i)
+{
+    return static_cast<uint16_t>(bytes[i * 2]) | (static_cast<uint16_t>(bytes[i * 2 + 1]) << 8);
+}
+
+// Returns the words from index i up to, but not including, the next 0x0000.
+static std::span<const uint8_t> wordsUntilNull(std::span<const uint8_t> bytes, size_t i)
+{
+    size_t n = bytes.size() / 2;
+    size_t end = i;
+
+    while (end < n && word(bytes, end) != 0x0000) end++;
+
+    if (i >= end) return {};
+    return bytes.subspan(i * 2, (end - i) * 2);
+}
+
+static std::span<const uint8_t> extractDataSizeBased(std::span<const uint8_t> hpprgm)
+{
+    if (hpprgm.size() < 2)
+        return {};
+
+    // 1. Read first word → number of bytes
+    uint16_t byteCount = word(hpprgm, 0);
+
+    // 2. Add an extra 4 bytes
+    byteCount += 4;
+
+    // 3. Convert byte count to 16-bit word count
+    size_t wordCount = byteCount / 2;         // bytes → words
+    if (byteCount % 2 != 0) wordCount++;      // round up, safety
+
+    // 3. Capture all values until 0x0000
+    return wordsUntilNull(hpprgm, wordCount + 2);
+}
+
+static std::span<const uint8_t> extractData(std::span<const uint8_t> hpprgm)
+{
+    size_t n = hpprgm.size() / 2;
+    size_t i = 0;
+
+    // 1. Find the starting 32-bit signature: 0xB28A617C
+    while (i + 1 < n) {
+        if (word(hpprgm, i) == 0x617C && word(hpprgm, i + 1) == 0xB28A)
+            break; // found signature
+        i++;
+    }
+
+    if (i + 1 >= n)
+        return {}; // signature not found
+
+    i += 2; // move past signature
+
+    // 2. Find 0x009B followed by 0x00C0
+    while (i + 1 < n) {
+        if (word(hpprgm, i) == 0x009B && word(hpprgm, i + 1) == 0x00C0)
+            break; // found the marker
+        i++;
+    }
+
+    if (i + 1 >= n)
+        return {}; // not found
+
+    i += 2; // move past 009B 00C0
+
+    // 3. Capture all values until 0x0000
+    return wordsUntilNull(hpprgm, i);
+}
+
+// Locates the UTF-16LE source code within the container, without copying it.
+static std::span<const uint8_t> payload(std::span<const uint8_t> hpprgm)
+{
+    auto prgm = extractData(hpprgm);
+    if (prgm.empty()) {
+        prgm = extractDataSizeBased(hpprgm);
+    }
+    return prgm;
+}
+
+/*
+ Decodes UTF-8, passing each UTF-16 code unit to emit. Invalid bytes are skipped, and a
+ sequence interrupted by a byte that is not a continuation byte is dropped along with it.
+ */
+template<typename Emit>
+static inline void decodeUTF8(std::string_view s, Emit&& emit)
+{
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(s.data());
+    size_t size = s.size();
+    size_t i = 0;
+
+    while (i < size) {
+        // ASCII fast path, 8 bytes at a time.
+        while (i + 8 <= size) {
+            uint64_t v;
+            std::memcpy(&v, src + i, sizeof(v));
+            if (v & 0x8080808080808080ULL) break;
+            for (int k = 0; k < 8; k++) emit(src[i + k]);
+            i += 8;
+        }
+        if (i >= size) break;
+
+        unsigned char c = src[i];
+        uint32_t code;
+        int bytesNeeded;
+
+        if (c <= 0x7F) {
+            // 1-byte ASCII
+            emit(c);
+            i++;
+            continue;
+        }
+        else if ((c & 0xE0) == 0xC0) {
+            code = c & 0x1F;
+            bytesNeeded = 1;
+        }
+        else if ((c & 0xF0) == 0xE0) {
+            code = c & 0x0F;
+            bytesNeeded = 2;
+        }
+        else if ((c & 0xF8) == 0xF0) {
+            code = c & 0x07;
+            bytesNeeded = 3;
+        }
+        else {
+            // invalid UTF-8 start byte
+            i++;
+            continue;
+        }
+        i++;
+
+        // continuation bytes
+        while (bytesNeeded && i < size && (src[i] & 0xC0) == 0x80) {
+            code = (code << 6) | (src[i] & 0x3F);
+            bytesNeeded--;
+            i++;
+        }
+        if (bytesNeeded) {
+            // invalid or truncated UTF-8 continuation
+            if (i < size) i++;
+            continue;
+        }
+
+        if (code <= 0xFFFF) {
+            // Direct UTF-16
+            emit(static_cast<uint16_t>(code));
+        }
+        else {
+            // Surrogate pair
+            code -= 0x10000;
+            emit(static_cast<uint16_t>(0xD800 + (code >> 10)));
+            emit(static_cast<uint16_t>(0xDC00 + (code & 0x3FF)));
+        }
+    }
+}
+
+// Transcodes UTF-16LE bytes straight to UTF-8, combining surrogate pairs.
+static std::string utf8(std::span<const uint8_t> utf16le)
+{
+    std::string out;
+    out.resize(utf16le.size() / 2 * 3);
+
+    char* dst = out.data();
+    size_t n = 0;
+    size_t count = utf16le.size() / 2;
+    size_t i = 0;
+
+    while (i < count) {
+        // ASCII fast path, 4 code units at a time.
+        while (i + 4 <= count) {
+            uint64_t v;
+            std::memcpy(&v, utf16le.data() + i * 2, sizeof(v));
+            if (v & 0xFF80FF80FF80FF80ULL) break;
+            dst[n++] = utf16le[i * 2];
+            dst[n++] = utf16le[i * 2 + 2];
+            dst[n++] = utf16le[i * 2 + 4];
+            dst[n++] = utf16le[i * 2 + 6];
+            i += 4;
+        }
+        if (i >= count) break;
+
+        uint32_t code = word(utf16le, i++);
+
+        if (code >= 0xD800 && code <= 0xDBFF && i < count) {
+            uint32_t low = word(utf16le, i);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+
+        if (code <= 0x7F) {
+            dst[n++] = static_cast<char>(code);
+        }
+        else if (code <= 0x07FF) {
+            dst[n++] = static_cast<char>(0xC0 | (code >> 6));
+            dst[n++] = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code <= 0xFFFF) {
+            dst[n++] = static_cast<char>(0xE0 | (code >> 12));
+            dst[n++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            dst[n++] = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            dst[n++] = static_cast<char>(0xF0 | (code >> 18));
+            dst[n++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            dst[n++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            dst[n++] = static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    out.resize(n);
+    return out;
+}
+
+
+// MARK: - 📣 Public API functions
+
+void hpprgm::create(const std::filesystem::path& path, const std::string& prgm)
+{
+    std::vector<uint8_t> header = {
+        0x0C, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    // Size in bytes of the UTF-16LE source code, including the terminating 0x0000.
+    size_t units = 1;
+    decodeUTF8(prgm, [&units](uint16_t) { units++; });
+    auto prgmSize = units * 2;
+
+    header.push_back(prgmSize & 0xFF);
+    header.push_back((prgmSize >> 8) & 0xFF);
+    header.push_back((prgmSize >> 16) & 0xFF);
+    header.push_back(prgmSize >> 24);
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Cannot write file");
+    f.write((const char*)header.data(), header.size());
+
+    uint8_t block[BLOCK_SIZE];
+    size_t n = 0;
+    auto put = [&](uint16_t v) {
+        block[n++] = v & 0xFF;
+        block[n++] = (v >> 8) & 0xFF;
+        if (n == BLOCK_SIZE) {
+            f.write((const char*)block, n);
+            n = 0;
+        }
+    };
+
+    decodeUTF8(prgm, put);
+    put(0);
+    f.write((const char*)block, n);
+}
+
+std::wstring hpprgm::prgm(const std::filesystem::path& path)
+{
+    MappedFile file(path);
+    auto prgm = payload(file.bytes());
+
+    std::wstring wstr;
+    wstr.resize(prgm.size() / 2);
+    for (size_t i = 0; i < wstr.size(); i++) {
+        wstr[i] = static_cast<wchar_t>(word(prgm, i));
+    }
+
+    return wstr;
+}
+
+std::string hpprgm::load(const std::filesystem::path& path)
+{
+    MappedFile file(path);
+    return utf8(payload(file.bytes()));
+}
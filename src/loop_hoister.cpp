@@ -0,0 +1,330 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "loop_hoister.hpp"
+#include "lexer.hpp"
+#include "expression.hpp"
+
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+
+using pplplus::LoopHoister;
+using pplplus::Lexer;
+using pplplus::Expression;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 16
+
+typedef struct TLoop {
+    size_t start;           // FOR, WHILE or REPEAT.
+    size_t first;           // The tokens evaluated on every pass, from TO or the condition.
+    size_t last;
+    size_t body;            // The statements of the loop.
+    size_t bodyEnd;
+    size_t end;             // The last token of the loop.
+    bool once;              // The body is sure to run at least once.
+} TLoop;
+
+static size_t find(const std::vector<TToken>& tokens, size_t i, size_t end, std::string_view text) {
+    while (i < end && !Lexer::isIdentifier(tokens[i], text)) i++;
+    return i;
+}
+
+// Locals and parameters of the function.
+static std::unordered_set<std::string> locals(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    std::unordered_set<std::string> names;
+    for (size_t i = function.params + 1; i < function.begin && !Lexer::isOperator(tokens[i], ")"); i++) {
+        if (tokens[i].type == Type::Identifier) names.insert(tokens[i].text);
+    }
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isStatementStart(tokens, i)) continue;
+        size_t end = Lexer::statementEnd(tokens, i);
+        int depth = 0;
+        bool declarator = true;
+        for (size_t j = i + 1; j <= end && j < function.end; j++) {
+            const TToken& token = tokens[j];
+            if (token.type == Type::Operator) {
+                if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+                if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+                if (depth == 0 && token.text == ",") declarator = true;
+                continue;
+            }
+            if (declarator && depth == 0 && token.type == Type::Identifier) names.insert(token.text);
+            declarator = false;
+        }
+        i = end;
+    }
+    return names;
+}
+
+static bool isTrue(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    double value;
+    return first <= last && Expression::evaluate(tokens, first, last, value) && value != 0;
+}
+
+static bool loop(const std::vector<TToken>& tokens, size_t i, size_t end, TLoop& loop) {
+    if (Lexer::isIdentifier(tokens[i], "REPEAT")) {
+        int repeats = 0;
+        size_t until = i;
+        for (; until < end; until++) {
+            if (Lexer::isIdentifier(tokens[until], "REPEAT")) repeats++;
+            if (Lexer::isIdentifier(tokens[until], "UNTIL") && --repeats == 0) break;
+        }
+        size_t last = Lexer::statementEnd(tokens, i);
+        if (until >= end || last >= end) return false;
+        if (Lexer::isOperator(tokens[last], ";")) last--;
+        loop = {i, i + 1, last, i + 1, until - 1, last, true};
+        return true;
+    }
+    
+    bool isFor = Lexer::isIdentifier(tokens[i], "FOR");
+    if (!isFor && !Lexer::isIdentifier(tokens[i], "WHILE")) return false;
+    
+    size_t last = Lexer::blockEnd(tokens, i);
+    size_t doing = find(tokens, i, last, "DO");
+    if (last >= end || doing >= last) return false;
+    
+    if (!isFor) {
+        loop = {i, i + 1, last - 1, doing + 1, last - 1, last, isTrue(tokens, i + 1, doing - 1)};
+        return true;
+    }
+    
+    // FOR v FROM a TO b [STEP c] DO
+    size_t from = find(tokens, i, doing, "FROM");
+    size_t to = find(tokens, i, doing, "TO");
+    bool down = to >= doing;
+    if (down) to = find(tokens, i, doing, "DOWNTO");
+    if (from >= doing || to >= doing) return false;
+    
+    size_t step = find(tokens, to, doing, "STEP");
+    double a, b;
+    bool once = step >= doing && Expression::evaluate(tokens, from + 1, to - 1, a) &&
+    Expression::evaluate(tokens, to + 1, doing - 1, b) && (down ? a >= b : a <= b);
+    
+    loop = {i, to, last - 1, doing + 1, last - 1, last, once};
+    return true;
+}
+
+// Variables the loop may change, including any named in a string that may be run by EXPR.
+static std::unordered_set<std::string> written(const std::vector<TToken>& tokens, const TLoop& loop) {
+    std::unordered_set<std::string> names;
+    for (size_t i = loop.start; i <= loop.end; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::String || token.type == Type::Directive) {
+            for (std::string_view word : Lexer::words(token.text)) names.insert(std::string(word));
+            continue;
+        }
+        if (token.type != Type::Identifier) continue;
+        
+        size_t next = i + 1;
+        if (next <= loop.end && (Lexer::isOperator(tokens[next], "(") || Lexer::isOperator(tokens[next], "["))) {
+            next = Lexer::closing(tokens, next, loop.end + 1) + 1;
+        }
+        if ((next <= loop.end && Lexer::isOperator(tokens[next], ":=")) ||
+            (i > 0 && (Lexer::isOperator(tokens[i - 1], "▶") || Lexer::isIdentifier(tokens[i - 1], "FOR")))) {
+            names.insert(token.text);
+        }
+        if (Lexer::isIdentifier(token, "LOCAL")) {
+            // Every variable declared in the loop is set again on each pass.
+            size_t end = Lexer::statementEnd(tokens, i);
+            for (size_t j = i + 1; j <= end && j <= loop.end; j++) {
+                if (tokens[j].type == Type::Identifier) names.insert(tokens[j].text);
+            }
+        }
+    }
+    return names;
+}
+
+/*
+ Tokens of the body that run on the first pass for certain: those outside any nested
+ block that come before anything that could leave the pass early.
+ */
+static std::vector<bool> certain(const std::vector<TToken>& tokens, const TLoop& loop) {
+    std::vector<bool> result(loop.end - loop.start + 1, false);
+    for (size_t i = loop.first; i < loop.body; i++) result[i - loop.start] = true;
+    if (!loop.once) return result;
+    
+    for (size_t i = loop.body; i <= loop.bodyEnd; i++) {
+        const TToken& token = tokens[i];
+        if (Lexer::isIdentifier(token, "BREAK") || Lexer::isIdentifier(token, "CONTINUE") || Lexer::isIdentifier(token, "RETURN")) break;
+        if (Lexer::isBlockStart(token) || Lexer::isIdentifier(token, "REPEAT")) {
+            i = Lexer::statementEnd(tokens, i);
+            continue;
+        }
+        result[i - loop.start] = true;
+    }
+    return result;
+}
+
+/*
+ True if tokens first to last only use invariant locals, numbers, strings and pure
+ built-ins. Sets fallible if they could raise an error, by dividing, indexing a list or
+ calling a built-in outside of its domain, and so must not run unless the loop would.
+ */
+static bool isInvariant(const std::vector<TToken>& tokens, size_t first, size_t last,
+                        const std::unordered_set<std::string>& locals, const std::unordered_set<std::string>& written, bool& fallible) {
+    static const std::unordered_set<std::string> partial = {
+        "SQRT", "LN", "LOG", "ASIN", "ACOS", "TAN"
+    };
+    
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Number || token.type == Type::String) continue;
+        if (token.type == Type::Operator) {
+            if (token.text == ":=" || token.text == "▶" || token.text == ".") return false;
+            if (token.text == "/" || token.text == "^") fallible = true;
+            continue;
+        }
+        if (size_t name = Lexer::pureCall(tokens, i); name && i + name <= last) {
+            if (partial.contains(token.text)) fallible = true;
+            i += name - 1;
+            continue;
+        }
+        if (token.type != Type::Identifier) return false;
+        if (token.text == "MOD" || token.text == "DIV") fallible = true;
+        if (token.text == "AND" || token.text == "OR" || token.text == "NOT" || token.text == "XOR" ||
+            token.text == "MOD" || token.text == "DIV" || token.text == "π") continue;
+        if (Lexer::isKeyword(token.text)) return false;
+        
+        if (!locals.contains(token.text) || written.contains(token.text)) return false;
+        if (i + 1 <= last && Lexer::isOperator(tokens[i + 1], "(")) fallible = true;
+    }
+    return true;
+}
+
+static std::string key(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    std::string text;
+    for (size_t i = first; i <= last; i++) text += tokens[i].text + " ";
+    return text;
+}
+
+static std::string indentation(std::string_view code, size_t offset) {
+    size_t start = code.rfind('\n', offset);
+    start = start == std::string_view::npos ? 0 : start + 1;
+    size_t end = start;
+    while (end < offset && (code[end] == ' ' || code[end] == '\t')) end++;
+    return std::string(code.substr(start, end - start));
+}
+
+// MARK: - Loops
+
+static void hoist(std::string_view code, const std::vector<TToken>& tokens, const TLoop& loop,
+                  const std::unordered_set<std::string>& locals, std::unordered_set<std::string>& used,
+                  Edits& edits, LoopHoister::TReport& report) {
+    std::unordered_set<std::string> changed = written(tokens, loop);
+    std::vector<bool> once = certain(tokens, loop);
+    
+    // The expressions to move, in the order first seen, with where each is used.
+    std::vector<std::string> order;
+    std::unordered_map<std::string, std::vector<std::pair<size_t, size_t>>> uses;
+    
+    for (size_t i = loop.first; i <= loop.last; i++) {
+        const TToken& token = tokens[i];
+        size_t name = std::max<size_t>(Lexer::pureCall(tokens, i), 1);
+        if (token.type != Type::Identifier || i + name > loop.last || !Lexer::isOperator(tokens[i + name], "(")) continue;
+        if (Lexer::isOperator(tokens[i - 1], ".")) continue;
+        
+        size_t close = Lexer::closing(tokens, i + name, loop.last + 1);
+        if (close > loop.last || close == i + name + 1) continue;
+        if (close + 1 <= loop.end && Lexer::isOperator(tokens[close + 1], ":=")) continue;
+        
+        bool fallible = false;
+        if (!isInvariant(tokens, i, close, locals, changed, fallible)) continue;
+        if (fallible && !once[i - loop.start]) continue;
+        
+        std::string text = key(tokens, i, close);
+        if (!uses.contains(text)) order.push_back(text);
+        uses[text].push_back({i, close});
+        i = close;
+    }
+    if (order.empty()) return;
+    
+    std::string declarations;
+    size_t count = 0;
+    for (const std::string& text : order) {
+        const auto& sites = uses[text];
+        std::string name = Lexer::fresh("inv", used);
+        
+        size_t replaced = 0;
+        for (const auto& [first, last] : sites) {
+            size_t start = tokens[first].offset;
+            if (edits.add({start, tokens[last].offset + tokens[last].text.size() - start, name})) replaced++;
+        }
+        if (!replaced) {
+            used.erase(name);
+            continue;
+        }
+        
+        const auto& [first, last] = sites.front();
+        declarations += (declarations.empty() ? "LOCAL " : ", ") + name + " := " + std::string(Lexer::text(code, tokens, first, last));
+        count++;
+    }
+    if (!count) return;
+    
+    size_t start = tokens[loop.start].offset;
+    if (edits.add({start, 0, declarations + ";\n" + indentation(code, start)})) {
+        report.loops++;
+        report.hoisted += count;
+    }
+}
+
+// MARK: - Public Methods
+
+std::string LoopHoister::hoist(const std::string& code) {
+    _report = TReport();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        
+        std::unordered_set<std::string> used;
+        for (const TToken& token : tokens) {
+            if (token.type == Type::Identifier) used.insert(token.text);
+            if (token.type == Type::String || token.type == Type::Directive) {
+                for (std::string_view word : Lexer::words(token.text)) used.insert(std::string(word));
+            }
+        }
+        
+        Edits edits;
+        for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+            if (function.end >= tokens.size()) continue;
+            std::unordered_set<std::string> names = locals(tokens, function);
+            
+            for (size_t i = function.begin + 1; i < function.end; i++) {
+                TLoop found;
+                if (!Lexer::isStatementStart(tokens, i) || !loop(tokens, i, function.end, found)) continue;
+                ::hoist(result, tokens, found, names, used, edits, _report);
+            }
+        }
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
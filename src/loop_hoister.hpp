@@ -0,0 +1,59 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LOOP_HOISTER_HPP
+#define LOOP_HOISTER_HPP
+
+#include <string>
+
+namespace pplplus {
+    /*
+     Moves expressions that give the same value on every pass of a FOR, WHILE or REPEAT
+     loop out of the loop, into a new local assigned just before it, for example
+     SIZE(L) in FOR i FROM 1 TO SIZE(L) DO, or L(3) where L is not changed in the loop.
+     
+     Only calls to built-ins with no side effects, and lookups in lists held by locals,
+     are moved, and only when every variable they use is a local or parameter that the
+     loop does not assign to. A list lookup could fail, so it is only moved when the
+     loop would have made it anyway on its first pass.
+     */
+    class LoopHoister {
+    public:
+        typedef struct TReport {
+            size_t loops = 0;
+            size_t hoisted = 0;
+        } TReport;
+        
+        std::string hoist(const std::string& code);
+        
+        const TReport& report(void) const {
+            return _report;
+        }
+        
+    private:
+        TReport _report;
+    };
+}
+
+#endif // LOOP_HOISTER_HPP
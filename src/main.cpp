@@ -38,12 +38,18 @@
 #include <string>
 #include <ranges>
 #include <unordered_set>
+#include <memory>
+#include <map>
+#include <future>
+#include <thread>
+#include <chrono>
 
 #include "timer.hpp"
 #include "singleton.hpp"
 
 #include "preprocessor.hpp"
 #include "dictionary.hpp"
+#include "table.hpp"
 #include "alias.hpp"
 #include "base.hpp"
 #include "calc.hpp"
@@ -53,10 +59,27 @@
 #include "ppl.hpp"
 #include "unary.hpp"
 #include "minifier.hpp"
-#include "reformat.hpp"
+#include "reformatter.hpp"
+#include "tree_shaker.hpp"
+#include "dead_code.hpp"
+#include "constant_folder.hpp"
+#include "inliner.hpp"
+#include "loop_hoister.hpp"
+#include "common_subexpression.hpp"
+#include "peephole.hpp"
+#include "vectorizer.hpp"
+#include "memoizer.hpp"
+#include "fixed_point.hpp"
+#include "instrumenter.hpp"
+#include "interpreter.hpp"
 #include "extensions.hpp"
 #include "tool.hpp"
+#include "plugin.hpp"
+#include "addon_cache.hpp"
 #include "pascal.hpp"
+#include "source.hpp"
+#include "sink.hpp"
+#include "batch.hpp"
 
 #include "../version_code.h"
 
@@ -71,8 +94,14 @@ using pplplus::Aliases;
 using pplplus::Alias;
 using pplplus::Calc;
 using pplplus::Dictionary;
+using pplplus::Table;
+using pplplus::Memoizer;
 using pplplus::Preprocessor;
 using pplplus::Base;
+using pplplus::Source;
+using pplplus::OutputSink;
+using pplplus::Batch;
+using pplplus::AddonCache;
 
 using std::regex_replace;
 using std::sregex_iterator;
@@ -84,6 +113,16 @@ namespace rc = std::regex_constants;
 static Preprocessor preprocessor = Preprocessor();
 static std::string assignment = "=";
 
+// Token budget for inlining small functions, set by #pragma mode( inline(budget) ) or --inline, 0 if off.
+static size_t inlineBudget = 0;
+
+// Functions to cache the results of, named by #pragma memo.
+static pplplus::Memoizer memoizer;
+
+// Format for LOCAL FIXED variables, set by #pragma mode( fixed(Qm.n) ), and whether it has been.
+static pplplus::FixedPoint fixedPoint;
+static bool fixedPointMode = false;
+
 typedef struct {
     std::string command;
     std::string extension;
@@ -99,6 +138,45 @@ static std::vector<addon_t> addons = {
 #endif
 };
 
+static AddonCache addonCache;
+
+/*
+ Converts the file with the add-on, in-process when the add-on is installed as a
+ library and otherwise by running its executable. Results are served from the
+ add-on cache when the same file has been converted by the same add-on before.
+ */
+static tool::result_t convertWithAddon(const addon_t& addon, const fs::path& path) {
+    std::vector<std::string> arguments = {"-o", "/dev/stdout"};
+    
+    return addonCache.run(addon.command, arguments, path, [&addon, &path, &arguments]() {
+        if (plugin::available(addon.command)) {
+            return plugin::convert(addon.command, path);
+        }
+        std::vector<std::string> args = {path.string()};
+        args.insert(args.end(), arguments.begin(), arguments.end());
+        return tool::runTool(addon.command, args);
+    });
+}
+
+// Add-on conversions already running in the background, by input file.
+static std::map<fs::path, std::future<tool::result_t>> pendingAddons;
+
+static std::future<tool::result_t> runAddonAsync(const addon_t& addon, const fs::path& path) {
+    return std::async(std::launch::async, [addon, path]() {
+        return convertWithAddon(addon, path);
+    });
+}
+
+static tool::result_t runAddon(const addon_t& addon, const fs::path& path) {
+    auto it = pendingAddons.find(path);
+    if (it != pendingAddons.end()) {
+        tool::result_t result = it->second.get();
+        pendingAddons.erase(it);
+        return result;
+    }
+    return convertWithAddon(addon, path);
+}
+
 
 // MARK: - Other
 
@@ -546,14 +624,13 @@ std::string include(const std::filesystem::path& path) {
     }
     
     if (ext == ".hpprgm" || ext == ".hpappprgm") {
-        std::wstring prgm = hpprgm::prgm(path);
-        output = utf::utf8(prgm);
+        output = hpprgm::load(path);
     }
     
     if (!addons.empty()) {
         for (const addon_t &addon : addons) {
             if (ext != addon.extension) continue;
-            auto result = tool::runTool(addon.command, {path.string(), "-o", "/dev/stdout"});
+            auto result = runAddon(addon, path);
             if (result.exitCode == 0) {
                 output = result.out;
             }
@@ -562,13 +639,7 @@ std::string include(const std::filesystem::path& path) {
     }
     
     if (output.empty()) {
-        utf::BOM bom = utf::bom(path);
-        if (bom == utf::BOMnone) {
-            output = utf::load(path);
-        } else {
-            auto utf16 = utf::load(path, bom);
-            output = utf::utf8(utf16);
-        }
+        output = utf::loadText(path);
     }
     
     if (!output.empty()) {
@@ -598,25 +669,26 @@ bool isPPLBlock(const std::string& str) {
     return str.find("#PPL") != std::string::npos;
 }
 
-std::string processPPLBlock(std::istringstream& iss) {
-    std::string str;
+std::string processPPLBlock(Source& source) {
+    std::string_view str;
     std::string output;
     
     Singleton::shared()->incrementLineNumber();
     
-    while(getline(iss, str)) {
-        if (str.find("#END") != std::string::npos) {
+    while(source.getline(str)) {
+        if (str.find("#END") != std::string_view::npos) {
             Singleton::shared()->incrementLineNumber();
             return output;
         }
         
-        output += str + '\n';
+        output.append(str);
+        output += '\n';
         Singleton::shared()->incrementLineNumber();
     }
-    return str;
+    return std::string(str);
 }
 
-std::string processPythonBlock(std::istringstream& iss, const std::string& input) {
+std::string processPythonBlock(Source& source, const std::string& input) {
     std::regex re;
     std::string str;
     std::string output;
@@ -658,7 +730,7 @@ std::string processPythonBlock(std::istringstream& iss, const std::string& input
         output = "#PYTHON\n";
     }
 
-    while(getline(iss, str)) {
+    while(source.getline(str)) {
         if (str.find("#END") != std::string::npos) {
             output += "#END\n";
             Singleton::shared()->incrementLineNumber();
@@ -694,6 +766,71 @@ static bool is_all_whitespace(const std::string& s) {
     return trimmed.begin() == trimmed.end();
 }
 
+static fs::path resolveIncludePath(std::string_view name, const fs::path& current_path)
+{
+    fs::path file_path = std::string(name);
+
+    if (file_path.parent_path().empty() && !fs::exists(file_path))
+        file_path = current_path.parent_path() / file_path;
+
+    return file_path;
+}
+
+/*
+ Scans the code for `{$I ...}` includes of files handled by add-ons, including any
+ add-ons declared with `#pragma mode(addon(...))` in the same code, and starts their
+ conversions in the background so they run while the rest of the file is translated.
+ */
+static void prefetchAddonIncludes(std::string_view code, const fs::path& current_path)
+{
+    static const std::regex pragma(R"(#pragma mode *\(.*\baddon\(([A-Za-z0-9 _.-]+)(\.[A-Za-z0-9]{1,10})\))");
+
+    if (code.find("{$") == std::string_view::npos) return;
+
+    std::vector<addon_t> candidates = addons;
+    for (size_t pos = code.find("#pragma mode"); pos != std::string_view::npos; pos = code.find("#pragma mode", pos + 1)) {
+        std::string line(code.substr(pos, code.find('\n', pos) - pos));
+        std::smatch match;
+        if (std::regex_search(line, match, pragma)) {
+            candidates.push_back({.command = match.str(1), .extension = match.str(2)});
+        }
+    }
+
+    for (size_t pos = code.find("{$"); pos != std::string_view::npos; pos = code.find("{$", pos + 2)) {
+        std::string_view s = code.substr(pos + 2);
+
+        if (s.starts_with("I"))
+            s.remove_prefix(1);
+        else if (s.starts_with("include") || s.starts_with("INCLUDE"))
+            s.remove_prefix(7);
+        else
+            continue;
+
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            s.remove_prefix(1);
+
+        char quote = 0;
+        if (!s.empty() && (s.front() == '"' || s.front() == '\'')) {
+            quote = s.front();
+            s.remove_prefix(1);
+        }
+
+        size_t end = quote ? s.find(quote) : s.find('}');
+        if (end == std::string_view::npos) continue;
+
+        fs::path path = resolveIncludePath(s.substr(0, end), current_path);
+        auto ext = std::lowercased(path.extension().string());
+
+        if (pendingAddons.contains(path) || !fs::exists(path)) continue;
+
+        for (const addon_t& addon : candidates) {
+            if (ext != addon.extension) continue;
+            pendingAddons[path] = runAddonAsync(addon, path);
+            break;
+        }
+    }
+}
+
 std::string processInclude(const std::string& input, const fs::path& current_path)
 {
     std::string output;
@@ -729,10 +866,7 @@ std::string processInclude(const std::string& input, const fs::path& current_pat
     if (end == std::string_view::npos)
         return input;
 
-    fs::path file_path = std::string(s.substr(0, end));
-
-    if (file_path.parent_path().empty() && !fs::exists(file_path))
-        file_path = current_path.parent_path() / file_path;
+    fs::path file_path = resolveIncludePath(s.substr(0, end), current_path);
 
     output += include(file_path);
 
@@ -745,44 +879,48 @@ std::string processInclude(const std::string& input, const fs::path& current_pat
     return output;
 }
 
-std::string translatePPLPlusToPPL(const fs::path& path) {
+void translatePPLPlusToPPL(const fs::path& path, OutputSink& output) {
     Singleton& singleton = *Singleton::shared();
-    std::istringstream iss;
     std::regex re;
     std::string input;
-    std::string output;
-    std::string code;
+    std::string_view line;
+    long joined;
 
     singleton.pushPath(path);
-    code = utf::load(path);
-    
-    code = pplplus::pascal::convertPascalSyntax(code);
     
+    /*
+     The source is memory-mapped and read a line at a time as views into the mapping,
+     only when Pascal syntax needs converting is a converted copy of the code made.
+     */
+    auto source = std::make_unique<Source>(path);
+    if (pplplus::pascal::requiresConversion(source->view())) {
+        source = std::make_unique<Source>(pplplus::pascal::convertPascalSyntax(std::string(source->view())));
+    }
+    prefetchAddonIncludes(source->view(), path);
     
-    iss.str(code);
-    while (getline(iss, input)) {
+    while (source->getLogicalLine(line, joined)) {
         /*
          Handle any escape lines `\` by continuing to read line joining them all up as one long line.
          */
+        for (long n = 0; n < joined; n++) {
+            Singleton::shared()->incrementLineNumber();
+        }
         
-        if (!input.empty()) {
-            while (input.at(input.length() - 1) == '\\' && !input.empty()) {
-                input.resize(input.length() - 1);
-                std::string s;
-                getline(iss, s);
-                input.append(s);
-                Singleton::shared()->incrementLineNumber();
-                if (s.empty()) break;
-            }
-        } else {
+        if (line.empty()) {
             Singleton::shared()->incrementLineNumber();
             output += "\n";
             continue;
         }
         
-        input = removeTripleSlashComment(input);
+        input.assign(line);
+        
+        if (input.find("///") != std::string::npos) {
+            input = removeTripleSlashComment(input);
+        }
         
-        input = regex_replace(input, std::regex(R"(\t)"), std::string(INDENT_WIDTH, ' '));
+        for (size_t pos = input.find('\t'); pos != std::string::npos; pos = input.find('\t', pos + INDENT_WIDTH)) {
+            input.replace(pos, 1, INDENT_WIDTH, ' ');
+        }
         
         if (input.find("#EXIT") != std::string::npos) {
             break;
@@ -791,16 +929,16 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
         while (preprocessor.disregard == true) {
             input = preprocessor.parse(input);
             Singleton::shared()->incrementLineNumber();
-            getline(iss, input);
+            if (!source->getline(input)) break;
         }
         
         if (isPythonBlock(input)) {
-            output += processPythonBlock(iss, input);
+            output += processPythonBlock(*source, input);
             continue;
         }
         
         if (isPPLBlock(input)) {
-            output += processPPLBlock(iss);
+            output += processPPLBlock(*source);
             continue;
         }
         
@@ -823,6 +961,19 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
                     indentation = atoi(it->str(2).c_str());
                     continue;
                 }
+                if (it->str(1) == "fixed") {
+                    if (fixedPoint.format(it->str(2))) {
+                        fixedPointMode = true;
+                    } else {
+                        std::cerr << MessageType::Warning << "#pragma mode: for '" << it->str() << "' invalid.\n";
+                    }
+                    continue;
+                }
+                if (it->str(1) == "inline") {
+                    int budget = atoi(it->str(2).c_str());
+                    inlineBudget = budget > 0 ? budget : INLINE_BUDGET;
+                    continue;
+                }
                 
                 if (it->str(1) == "separator" || it->str(1) == "integer") {
                     input.append(it->str() + " ");
@@ -847,6 +998,20 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
             continue;
         }
         
+        // Handle `#pragma memo` for PPL+
+        if (Memoizer::isMemoPragma(input)) {
+            memoizer.addPragma(input);
+            Singleton::shared()->incrementLineNumber();
+            continue;
+        }
+        
+        // Handle `#table` lookup tables computed at translation time.
+        if (Table::isTableDefinition(input)) {
+            output += Table::processTableDefinition(input);
+            Singleton::shared()->incrementLineNumber();
+            continue;
+        }
+        
         input = processInclude(input, path);
         
         if (preprocessor.isAngleInclude(input)) {
@@ -873,13 +1038,19 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
             continue;
         }
        
-        std::istringstream iss;
-        iss.str(input);
-        std::string str;
+        // Most lines are a single line, which needs no copying to be translated.
+        if (input.find('\n') == std::string::npos) {
+            std::string s = translatePPLPlusLine(input);
+            if (!is_all_whitespace(s)) output += s;
+            Singleton::shared()->incrementLineNumber();
+            continue;
+        }
         
-
-        while(getline(iss, str)) {
-            std::string s = translatePPLPlusLine(str);
+        std::string_view lines = input;
+        while (!lines.empty()) {
+            size_t length = std::min(lines.find('\n'), lines.size());
+            std::string s = translatePPLPlusLine(std::string(lines.substr(0, length)));
+            lines.remove_prefix(std::min(length + 1, lines.size()));
             if (is_all_whitespace(s)) {
                 continue;
             }
@@ -890,15 +1061,135 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
     }
     
     singleton.popPath();
+}
+
+std::string translatePPLPlusToPPL(const fs::path& path) {
+    OutputSink output;
+    translatePPLPlusToPPL(path, output);
+    return output.str();
+}
+
+/*
+ Translates straight into the output, transcoding and writing each chunk of the program
+ as it is produced, so only a chunk at a time is held in memory rather than the whole
+ program. Used when the output needs no further whole-program processing.
+ 
+ Returns false when nothing was written, in which case output holds the translation.
+ The whole translation is also held back in output if the source has a #pragma that
+ turns on a pass needing the whole program, such as inline. One that only turns up in
+ an included file after the first chunk has been written is an error.
+ */
+static bool needsWholeProgram(void) {
+    return inlineBudget > 0 || !memoizer.empty() || fixedPointMode;
+}
+
+// True if the line is a #pragma memo, or a #pragma mode with fixed( or inline(.
+static bool isWholeProgramPragma(std::string_view line) {
+    size_t pragma = line.find("#pragma");
+    if (pragma == std::string_view::npos) return false;
+    line.remove_prefix(pragma);
+    if (line.starts_with("#pragma memo")) return true;
+    return line.starts_with("#pragma mode") && (line.find("fixed(") != std::string_view::npos || line.find("inline(") != std::string_view::npos);
+}
+
+static bool hasWholeProgramPragma(const fs::path& path) {
+    pplplus::Source source(path);
+    std::string_view line;
+    while (source.getline(line)) {
+        if (isWholeProgramPragma(line)) return true;
+    }
+    return false;
+}
+
+static void reportLatePragma(void) {
+    std::cerr << MessageType::Error << "#pragma memo, mode( inline ) or mode( fixed ) found after output was written, move it into the main file.\n";
+}
+
+bool streamPPLPlusToPPL(const fs::path& inpath, const fs::path& outpath, std::string& output) {
+    bool held = needsWholeProgram() || hasWholeProgramPragma(inpath);
     
-    // Removes `uses`
-    output = regex_replace(output, std::regex(R"(\buses\s+([^;]+);)"), "\n");
+    if (outpath == "/dev/stdout") {
+        bool first = true;
+        OutputSink sink([&output, &first, &held](std::string_view chunk) {
+            if (first) held = held || needsWholeProgram();
+            first = false;
+            if (held) {
+                output.append(chunk);
+                return;
+            }
+            std::cout << chunk;
+        });
+        translatePPLPlusToPPL(inpath, sink);
+        sink.flush();
+        if (!held && needsWholeProgram()) reportLatePragma();
+        return !held && sink.written() > 0;
+    }
     
-    return output;
+    std::ofstream os;
+    os.open(outpath, std::ios::out | std::ios::binary);
+    if (!os.is_open()) {
+        output = translatePPLPlusToPPL(inpath);
+        return false;
+    }
+    
+    bool first = true;
+    OutputSink sink([&os, &output, &first, &held](std::string_view chunk) {
+        if (first) held = held || needsWholeProgram();
+        if (held) {
+            output.append(chunk);
+            first = false;
+            return;
+        }
+        utf::write(os, chunk, first ? utf::BOMle : utf::BOMnone);
+        first = false;
+    });
+    translatePPLPlusToPPL(inpath, sink);
+    sink.flush();
+    os.close();
+    if (!held && needsWholeProgram()) reportLatePragma();
+    
+    return !held && sink.written() > 0;
 }
 
-
 // MARK: - Command Line
+/*
+ Reformats the input again each time it is saved, until interrupted. The reformatter
+ keeps its cache between runs, so only the functions that changed are formatted again.
+ */
+static void watch(const fs::path& inpath, const fs::path& outpath, pplplus::Reformatter& reformatter) {
+    auto in_ext = std::lowercased(inpath.extension().string());
+    auto out_ext = std::lowercased(outpath.extension().string());
+    
+    std::error_code ec;
+    auto modified = fs::last_write_time(inpath, ec);
+    
+    std::cerr << "Watching " << inpath.filename() << " for changes, press Ctrl-C to stop.\n";
+    
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        
+        auto time = fs::last_write_time(inpath, ec);
+        if (ec || time == modified) continue;
+        modified = time;
+        
+        Timer timer;
+        std::string code = in_ext == ".hpprgm" || in_ext == ".hpappprgm" ? hpprgm::load(inpath) : utf::loadText(inpath);
+        std::string output = reformatter.reformat(code);
+        
+        if (outpath == "/dev/stdout") {
+            std::cout << output << std::flush;
+        } else if (out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
+            hpprgm::create(outpath, output);
+        } else if (!utf::save(outpath, std::string_view(output), utf::BOMle)) {
+            std::cerr << "❌ Unable to create file " << outpath.filename() << ".\n";
+            continue;
+        }
+        
+        std::cerr << "Reformatted " << reformatter.parts() - reformatter.reused() << " of " << reformatter.parts()
+                  << " parts in " << std::fixed << std::setprecision(2) << timer.elapsed() / 1e6 << " milliseconds\n";
+    }
+}
+
 void error(void) {
     std::cerr << COMMAND_NAME << ": try '" << COMMAND_NAME << " --help' for more information\n";
     exit(0);
@@ -912,13 +1203,35 @@ void help(void) {
     << "Insoft "<< NAME << " version, " << VERSION_NUMBER << " (BUILD " << BUNDLE_VERSION << ")\n"
     << "\n"
     << "Usage: " << COMMAND_NAME << " <input-file> [-o <output-file>] [-v]\n"
+    << "       " << COMMAND_NAME << " <directory> [-o <output-directory>] [-r] [-j <threads>] [-v]\n"
     << "\n"
     << "Options:\n"
     << "  -o <output-file>        Specify the filename for generated code.\n"
     << "  -c or --compress        Specify if the PPL code should be compressed.\n"
     << "  -r or --reformat        Specify if the PPL code should be reformated.\n"
+    << "  --map <file>            Write the variables renamed by --compress to <file>.\n"
+    << "  --tree-shake            Remove functions not reachable from EXPORT or KEY functions.\n"
+    << "  --inline                Replace calls to small functions with their body.\n"
+    << "  --fold                  Evaluate constant expressions and propagate constant locals.\n"
+    << "  --hoist                 Move expressions that do not change out of loops.\n"
+    << "  --cse                   Compute expressions repeated within a block once.\n"
+    << "  --peephole              Rewrite small patterns, such as x^2 to x*x, into faster forms.\n"
+    << "  --peephole-rules <list> Only apply the listed rules: square, shift, boolean, copy, not.\n"
+    << "  --vectorize             Replace simple FOR loops over lists with list operations.\n"
+    << "  --dce                   Remove dead code and unused variables within functions.\n"
+    << "  --instrument <file>     Time each function on the calculator, writing the sites to <file>.\n"
+    << "  --instrument-loops      Time each loop as well, used with --instrument.\n"
+    << "  --profile <file> <dump> Report where time went, from the sites <file> and the list dumped\n"
+    << "                          from the calculator.\n"
+    << "  --run <call>            Run the generated code offline, such as --run \"Main(10)\", and\n"
+    << "                          report the instructions and time spent in each function.\n"
+    << "  --watch                 Reformat the input again each time it changes, used with -r.\n"
+    << "  -j <threads>            Number of threads used to extract a directory.\n"
+    << "  --cache <directory>     Keep converted add-on includes in <directory> between builds.\n"
     << "  -v                      Display detailed processing information.\n"
     << "\n"
+    << "Given a directory, every .hpprgm and .hpappprgm within it is extracted to .prgm.\n"
+    << "\n"
     << "Additional Commands:\n"
     << "  " << COMMAND_NAME << " {--version | --help }\n"
     << "    --version              Display the version information.\n"
@@ -1026,6 +1339,22 @@ int main(int argc, char **argv) {
     bool verbose = false;
     bool minify = false;
     bool reformat = false;
+    fs::path mappath;
+    bool watching = false;
+    bool shake = false;
+    bool eliminate = false;
+    bool fold = false;
+    bool hoist = false;
+    bool share = false;
+    bool peephole = false;
+    bool vectorize = false;
+    fs::path sitespath;
+    bool instrumentLoops = false;
+    fs::path profilepath, dumppath;
+    std::string runcall;
+    pplplus::Peephole peepholeOptimizer;
+    fs::path batchpath;
+    unsigned threads = 0;
     
     std::string args(argv[0]);
     
@@ -1090,9 +1419,153 @@ int main(int argc, char **argv) {
             continue;
         }
         
+        if (args == "--inline") {
+            if (!inlineBudget) inlineBudget = INLINE_BUDGET;
+            continue;
+        }
+        
+        if (args == "--fold") {
+            fold = true;
+            continue;
+        }
+        
+        if (args == "--hoist") {
+            hoist = true;
+            continue;
+        }
+        
+        if (args == "--cse") {
+            share = true;
+            continue;
+        }
+        
+        if (args == "--peephole") {
+            peephole = true;
+            continue;
+        }
+        
+        if (args == "--peephole-rules") {
+            if (++n >= argc || !peepholeOptimizer.select(argv[n])) {
+                error();
+                exit(0);
+            }
+            peephole = true;
+            continue;
+        }
+        
+        if (args == "--vectorize") {
+            vectorize = true;
+            continue;
+        }
+        
+        if (args == "--dce") {
+            eliminate = true;
+            continue;
+        }
+        
+        if (args == "--tree-shake") {
+            shake = true;
+            continue;
+        }
+        
+        if (args == "--watch") {
+            watching = true;
+            continue;
+        }
+        
+        if (args == "--instrument") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            sitespath = fs::expand_tilde(fs::path(argv[n]));
+            continue;
+        }
+        
+        if (args == "--instrument-loops") {
+            instrumentLoops = true;
+            continue;
+        }
+        
+        if (args == "--profile") {
+            if ( n + 2 >= argc ) {
+                error();
+                exit(0);
+            }
+            profilepath = fs::expand_tilde(fs::path(argv[++n]));
+            dumppath = fs::expand_tilde(fs::path(argv[++n]));
+            continue;
+        }
+        
+        if (args == "--run") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            runcall = argv[n];
+            continue;
+        }
+        
+        if (args == "--map") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            mappath = fs::expand_tilde(fs::path(argv[n]));
+            continue;
+        }
+        
+        if (args == "--cache") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            addonCache.directory = fs::expand_tilde(fs::path(argv[n]));
+            continue;
+        }
+        
+        if (args == "-j") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            threads = static_cast<unsigned>(atoi(argv[n]));
+            continue;
+        }
+        
+        if (fs::is_directory(fs::expand_tilde(args))) {
+            batchpath = fs::expand_tilde(args);
+            continue;
+        }
+        
         inpath = resolveAndValidateInputFile(argv[n]);
     }
     
+    if (!profilepath.empty()) {
+        pplplus::Instrumenter::report(profilepath, dumppath, std::cout);
+        return 0;
+    }
+    
+    if (!batchpath.empty()) {
+        if (minify) {
+            std::cerr << "❌ error: -c is not supported when extracting a directory.\n";
+            return 0;
+        }
+        
+        Batch batch(batchpath, outpath);
+        batch.reformat = reformat;
+        batch.verbose = verbose;
+        batch.threads = threads;
+        size_t failed = batch.run();
+        
+        std::locale commaLocale(std::locale::classic(), new comma_numpunct);
+        std::cerr.imbue(commaLocale);
+        batch.summary(std::cerr);
+        
+        // Scripts extracting a backup can tell that some programs were not extracted.
+        return failed ? 1 : 0;
+    }
+    
     outpath = resolveOutputPath(inpath, outpath);
     
     if (outpath == inpath) {
@@ -1105,6 +1578,11 @@ int main(int argc, char **argv) {
     auto in_ext = std::lowercased(inpath.extension().string());
     auto out_ext = std::lowercased(outpath.extension().string());
     
+    if (watching && (!reformat || in_ext == ".prgm+" || in_ext == ".ppl+" || in_ext == ".pp")) {
+        std::cerr << "❌ error: --watch is only available when reformatting PPL with -r.\n";
+        exit(0);
+    }
+    
     std::string str;
     
     str = "#define __pplplus";
@@ -1123,7 +1601,7 @@ int main(int argc, char **argv) {
     Timer timer;
     
     std::string output;
-    
+    bool streamed = false;
     
     std::array<std::string, 3> extensions = {
         ".prgm+",
@@ -1133,7 +1611,11 @@ int main(int argc, char **argv) {
     for (auto extension : extensions) {
         if (in_ext == extension) {
             std::cerr << "Pre-Processing...\n";
-            output = translatePPLPlusToPPL(inpath);
+            if (reformat || minify || shake || eliminate || fold || hoist || share || peephole || vectorize || inlineBudget || !memoizer.empty() || fixedPointMode || !sitespath.empty() || !runcall.empty() || out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
+                output = translatePPLPlusToPPL(inpath);
+            } else {
+                streamed = streamPPLPlusToPPL(inpath, outpath, output);
+            }
             if (hasErrors() == true) {
                 std::cerr << "🛑 errors!" << "\n";
             }
@@ -1141,27 +1623,20 @@ int main(int argc, char **argv) {
         }
     }
     
-    if (output.empty()) {
+    if (!streamed && output.empty()) {
         if (in_ext == ".hpprgm" || in_ext == ".hpappprgm") {
-            std::wstring prgm = hpprgm::prgm(inpath);
-            output = utf::utf8(prgm);
+            output = hpprgm::load(inpath);
         }
     }
     
-    if (output.empty()) {
-        auto bom = utf::bom(inpath);
-        if (bom != utf::BOMnone) {
-            auto prgm = utf::load(inpath, bom);
-            output = utf::utf8(prgm);
-        } else {
-            output = utf::load(inpath);
-        }
+    if (!streamed && output.empty()) {
+        output = utf::loadText(inpath);
     }
     
-    if (output.empty()) {
+    if (!streamed && output.empty()) {
         for (const addon_t &addon : addons) {
             if (in_ext != addon.extension) continue;
-            auto result = tool::runTool(addon.command, {inpath.string(), "-o", "/dev/stdout"});
+            auto result = runAddon(addon, inpath);
             if (result.exitCode == 0) {
                 output = result.out;
             }
@@ -1169,16 +1644,125 @@ int main(int argc, char **argv) {
         }
     }
     
+    if (fixedPointMode) {
+        output = fixedPoint.convert(output);
+        
+        auto report = fixedPoint.report();
+        std::cerr << "Fixed point: " << report.variables << " variable(s), " << report.statements << " statement(s) converted\n";
+        for (const auto& problem : fixedPoint.problems()) {
+            std::cerr << "  " << problem.function << " at line " << problem.line << ": " << problem.reason << "\n";
+        }
+    }
+    
+    if (!memoizer.empty()) {
+        output = memoizer.memoize(output);
+        
+        std::cerr << "Memoized " << memoizer.memoized().size() << " function(s)\n";
+        for (const auto& function : memoizer.skipped()) {
+            std::cerr << "  " << function.name << " left alone: " << function.reason << "\n";
+        }
+    }
+    
+    if (inlineBudget) {
+        pplplus::Inliner inliner;
+        inliner.budget = inlineBudget;
+        output = inliner.inlineCalls(output);
+        
+        std::cerr << "Inlined " << inliner.sites().size() << " call(s)\n";
+        for (const auto& site : inliner.sites()) {
+            std::cerr << "  " << site.callee << " into " << site.caller << " at line " << site.line << "\n";
+        }
+    }
+    
+    if (fold == true) {
+        pplplus::ConstantFolder folder;
+        output = folder.fold(output);
+        
+        auto report = folder.report();
+        std::cerr << "Constants: " << report.folded << " expression(s) folded, " << report.propagated << " use(s) propagated\n";
+    }
+    
+    if (hoist == true) {
+        pplplus::LoopHoister hoister;
+        output = hoister.hoist(output);
+        
+        auto report = hoister.report();
+        std::cerr << "Loop invariants: " << report.hoisted << " expression(s) moved out of " << report.loops << " loop(s)\n";
+    }
+    
+    if (vectorize == true) {
+        pplplus::Vectorizer vectorizer;
+        output = vectorizer.vectorize(output);
+        
+        std::cerr << "Vectorized " << vectorizer.vectorized() << " loop(s), " << vectorizer.skipped().size() << " FOR loop(s) left as they are\n";
+        for (const auto& loop : vectorizer.skipped()) {
+            std::cerr << "  " << loop.function << " at line " << loop.line << ": " << loop.reason << "\n";
+        }
+    }
+    
+    if (share == true) {
+        pplplus::CommonSubexpressionEliminator eliminator;
+        output = eliminator.eliminate(output);
+        
+        auto report = eliminator.report();
+        std::cerr << "Common sub-expressions: " << report.replaced << " use(s) of " << report.temporaries << " expression(s) shared\n";
+    }
+    
+    if (peephole == true) {
+        output = peepholeOptimizer.optimize(output);
+        
+        auto report = peepholeOptimizer.report();
+        std::cerr << "Peephole: " << report.square << " square, " << report.shift << " shift, " << report.boolean << " boolean, "
+                  << report.copy << " copy, " << report.not_ << " not rewrite(s)\n";
+    }
+    
+    if (eliminate == true) {
+        pplplus::DeadCodeEliminator eliminator;
+        output = eliminator.eliminate(output);
+        
+        auto report = eliminator.report();
+        std::cerr << "Dead code removed: " << report.branches << " constant IF branch(es), " << report.unreachable
+                  << " unreachable statement(s), " << report.assignments << " unused assignment(s), " << report.locals << " unused local(s)\n";
+    }
+    
+    if (shake == true) {
+        pplplus::TreeShaker treeShaker;
+        output = treeShaker.shake(output);
+        
+        std::cerr << "Tree shaking removed " << treeShaker.removed().size() << " unused function(s)\n";
+        if (verbose) {
+            for (const std::string& name : treeShaker.removed()) std::cerr << "  " << name << "\n";
+        }
+    }
+    
+    if (!sitespath.empty()) {
+        pplplus::Instrumenter instrumenter;
+        instrumenter.loops = instrumentLoops;
+        output = instrumenter.instrument(output);
+        instrumenter.locate(utf::load(inpath), inpath.filename().string());
+        
+        std::cerr << "Instrumented " << instrumenter.sites().size() << " site(s) counted in " << instrumenter.list() << "\n";
+        if (!instrumenter.saveSites(sitespath)) {
+            std::cerr << "❌ Unable to create file " << sitespath.filename() << ".\n";
+        }
+    }
+    
+    pplplus::Reformatter reformatter;
     if (reformat == true) {
-        output = reformat::prgm(output);
+        output = reformatter.reformat(output);
     }
     
     if (minify == true) {
         // Percentage Reduction = (Original Size - New Size) / Original Size * 100
         std::ifstream::pos_type original_size = output.length();
-        output = minifier::minify(output);
+        pplplus::Minifier minifier;
+        output = minifier.minify(output);
         std::ifstream::pos_type new_size = output.length();
         
+        if (!mappath.empty() && !minifier.saveMap(mappath)) {
+            std::cerr << "❌ Unable to create file " << mappath.filename() << ".\n";
+        }
+        
         // Create a locale with the custom comma-based numpunct
         std::locale commaLocale(std::locale::classic(), new comma_numpunct);
         std::cerr.imbue(commaLocale);
@@ -1186,16 +1770,29 @@ int main(int argc, char **argv) {
         std::cerr << "PPL Code (deflated " << (original_size - new_size) * 100 / original_size << "%)\n";
     }
     
+    if (!runcall.empty() && !hasErrors()) {
+        pplplus::Interpreter interpreter;
+        std::string result;
+        if (interpreter.load(output) && interpreter.run(runcall, result)) {
+            std::cerr << "Result: " << result << "\n";
+            interpreter.report(std::cerr);
+        } else {
+            std::cerr << MessageType::Error << interpreter.error() << "\n";
+        }
+    }
+    
     
     if (outpath == "/dev/stdout") {
-        std::cout << output;
+        if (!streamed) std::cout << output;
         std::cerr << '\n';
     } else {
-        if (out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
+        if (streamed) {
+            // Already written while translating.
+        } else if (out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
             auto programName = inpath.stem().string();
             hpprgm::create(outpath, output);
         } else {
-            if (!utf::save(outpath, utf::utf16(output), utf::BOMle)) {
+            if (!utf::save(outpath, std::string_view(output), utf::BOMle)) {
                 std::cerr << "❌ Unable to create file " << outpath.filename() << ".\n";
                 return 0;
             }
@@ -1214,6 +1811,10 @@ int main(int argc, char **argv) {
         std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e9 << " seconds\n";
     }
     
+    if (watching) {
+        watch(inpath, outpath, reformatter);
+    }
+    
     return 0;
 }
 
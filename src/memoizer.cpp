@@ -0,0 +1,281 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "memoizer.hpp"
+#include "lexer.hpp"
+#include "common.hpp"
+
+#include <regex>
+#include <unordered_set>
+
+using pplplus::Memoizer;
+using pplplus::Lexer;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+// Built-ins whose result can differ between calls with the same arguments.
+static const std::unordered_set<std::string> volatiles = {
+    "RANDOM", "RANDINT", "RANDNORM", "RANDSEED", "GETKEY", "ISKEYDOWN", "MOUSE", "WAIT",
+    "INPUT", "CHOOSE", "MSGBOX", "TICKS", "TIME", "Date", "Time"
+};
+
+// Names declared by LOCAL statements from token first to last.
+static std::unordered_set<std::string> locals(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    std::unordered_set<std::string> names;
+    for (size_t i = first; i <= last; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "LOCAL") || !Lexer::isStatementStart(tokens, i)) continue;
+        size_t end = Lexer::statementEnd(tokens, i);
+        int depth = 0;
+        bool declarator = true;
+        for (size_t j = i + 1; j <= end && j <= last; j++) {
+            const TToken& token = tokens[j];
+            if (token.type == Type::Operator) {
+                if (token.text == "(" || token.text == "[" || token.text == "{") depth++;
+                if (token.text == ")" || token.text == "]" || token.text == "}") depth--;
+                if (depth == 0 && token.text == ",") declarator = true;
+                continue;
+            }
+            if (declarator && depth == 0 && token.type == Type::Identifier) names.insert(token.text);
+            declarator = false;
+        }
+        i = end;
+    }
+    return names;
+}
+
+static std::vector<std::string> parameters(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    std::vector<std::string> params;
+    for (size_t i = function.params + 1; i < function.begin; i++) {
+        if (Lexer::isOperator(tokens[i], ")")) break;
+        if (tokens[i].type == Type::Identifier) params.push_back(tokens[i].text);
+    }
+    return params;
+}
+
+// The variable assigned to by the := at index i, such as L in L(i) := x, or an empty string.
+static std::string target(const std::vector<TToken>& tokens, size_t i) {
+    if (i == 0) return "";
+    size_t j = i - 1;
+    if (Lexer::isOperator(tokens[j], ")")) {
+        int depth = 0;
+        for (; j > 0; j--) {
+            if (Lexer::isOperator(tokens[j], ")")) depth++;
+            if (Lexer::isOperator(tokens[j], "(")) depth--;
+            if (depth == 0) break;
+        }
+        if (j == 0) return "";
+        j--;
+    }
+    return tokens[j].type == Type::Identifier ? tokens[j].text : "";
+}
+
+// Why the body of a function cannot be cached, or an empty string if it can.
+static std::string impurity(const std::vector<TToken>& tokens, const Lexer::TFunction& function,
+                            const std::vector<std::string>& params) {
+    auto names = locals(tokens, function.begin + 1, function.end);
+    names.insert(params.begin(), params.end());
+    
+    for (size_t i = function.begin + 1; i < function.end; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Identifier && volatiles.count(token.text)) {
+            return "calls " + token.text;
+        }
+        
+        std::string name;
+        if (Lexer::isOperator(token, ":=")) name = target(tokens, i);
+        if (Lexer::isOperator(token, "▶") && i + 1 < function.end && tokens[i + 1].type == Type::Identifier) name = tokens[i + 1].text;
+        if (!name.empty() && !names.count(name)) {
+            return "assigns to global '" + name + "'";
+        }
+    }
+    return "";
+}
+
+static std::string join(const std::vector<std::string>& items) {
+    std::string s;
+    for (const auto& item : items) s += (s.empty() ? "" : ",") + item;
+    return s;
+}
+
+// MARK: -
+
+bool Memoizer::isMemoPragma(const std::string& str) {
+    static const std::regex re(R"(^ *#pragma memo\b)");
+    return std::regex_search(str, re);
+}
+
+bool Memoizer::addPragma(const std::string& str) {
+    static const std::regex pragma(R"(^ *#pragma memo *\((.*)\) *$)");
+    static const std::regex function(R"(([A-Za-z_]\w*) *\(([^()]*)\))");
+    static const std::regex comma(",");
+    static const std::regex range(R"(^ *(-?\d+) *\.\. *(-?\d+) *$)");
+    
+    std::smatch match;
+    if (!std::regex_search(str, match, pragma)) {
+        std::cerr << MessageType::Error << "#pragma memo: expected '#pragma memo( name(low..high, ...) )'\n";
+        return false;
+    }
+    
+    std::string list = match.str(1);
+    bool valid = false;
+    for (auto it = std::sregex_iterator(list.begin(), list.end(), function); it != std::sregex_iterator(); ++it) {
+        TRequest request = {.name = it->str(1), .ranges = {}};
+        size_t cells = 1;
+        
+        std::string ranges = it->str(2);
+        std::sregex_token_iterator part(ranges.begin(), ranges.end(), comma, -1), end;
+        for (; part != end; ++part) {
+            std::string text = part->str();
+            std::smatch bounds;
+            if (!std::regex_match(text, bounds, range) || std::stol(bounds.str(2)) < std::stol(bounds.str(1))) {
+                std::cerr << MessageType::Error << "#pragma memo: '" << text << "' for " << request.name << " is not a range such as 0..100\n";
+                return false;
+            }
+            TRange r = {std::stol(bounds.str(1)), std::stol(bounds.str(2))};
+            request.ranges.push_back(r);
+            
+            cells *= static_cast<size_t>(r.high - r.low + 1);
+            if (cells > LIST_LIMIT) {
+                std::cerr << MessageType::Error << "#pragma memo: the ranges for " << request.name << " cover more than " << LIST_LIMIT << " values\n";
+                return false;
+            }
+        }
+        
+        if (request.ranges.empty()) {
+            std::cerr << MessageType::Error << "#pragma memo: no ranges given for " << request.name << "\n";
+            return false;
+        }
+        
+        _requests.push_back(request);
+        valid = true;
+    }
+    
+    if (!valid) {
+        std::cerr << MessageType::Error << "#pragma memo: no function given\n";
+    }
+    return valid;
+}
+
+std::string Memoizer::memoize(const std::string& code) {
+    _memoized.clear();
+    _skipped.clear();
+    
+    auto tokens = Lexer::tokenize(code);
+    auto functions = Lexer::functions(tokens);
+    
+    std::unordered_set<std::string> used;
+    for (const auto& token : tokens) {
+        if (token.type == Type::Identifier) used.insert(token.text);
+    }
+    
+    Edits edits;
+    for (const auto& request : _requests) {
+        const Lexer::TFunction* function = nullptr;
+        for (const auto& f : functions) {
+            if (f.name == request.name) function = &f;
+        }
+        
+        if (!function) {
+            _skipped.push_back({request.name, "no such function"});
+            continue;
+        }
+        if (function->end + 1 >= tokens.size() || !Lexer::isOperator(tokens[function->end + 1], ";") ||
+            !Lexer::isIdentifier(tokens[function->params - 1], function->name)) {
+            _skipped.push_back({request.name, "not a plain function definition"});
+            continue;
+        }
+        
+        auto params = parameters(tokens, *function);
+        if (params.size() != request.ranges.size()) {
+            _skipped.push_back({request.name, "takes " + std::to_string(params.size()) + " argument(s) but " +
+                std::to_string(request.ranges.size()) + " range(s) were given"});
+            continue;
+        }
+        
+        std::string reason = impurity(tokens, *function, params);
+        if (!reason.empty()) {
+            _skipped.push_back({request.name, reason});
+            continue;
+        }
+        
+        std::string cache = Lexer::fresh(request.name + "_memo", used);
+        std::string body = Lexer::fresh(request.name + "_body", used);
+        std::unordered_set<std::string> taken(params.begin(), params.end());
+        std::string cell = Lexer::fresh("cell", taken);
+        
+        std::string args = join(params);
+        std::string guard;
+        std::vector<size_t> strides(params.size(), 1);
+        for (size_t i = params.size() - 1; i > 0; i--) {
+            strides[i - 1] = strides[i] * static_cast<size_t>(request.ranges[i].high - request.ranges[i].low + 1);
+        }
+        size_t cells = strides[0] * static_cast<size_t>(request.ranges[0].high - request.ranges[0].low + 1);
+        
+        // Row-major position of the arguments in the cache, counting from 1.
+        std::string index;
+        long base = 1;
+        for (size_t i = 0; i < params.size(); i++) {
+            const auto& p = params[i];
+            const auto& r = request.ranges[i];
+            guard += (i ? " OR " : "") + ("FP(" + p + ") OR " + p + " < " + std::to_string(r.low) + " OR " + p + " > " + std::to_string(r.high));
+            
+            index += (i ? "+" : "") + p + (strides[i] > 1 ? "*" + std::to_string(strides[i]) : "");
+            base -= r.low * static_cast<long>(strides[i]);
+        }
+        if (base > 0) index += "+" + std::to_string(base);
+        if (base < 0) index += std::to_string(base);
+        
+        // The cache and a forward declaration, so the renamed body can still call the function.
+        size_t name = function->params - 1;
+        std::string head = cache + " := {};\n" + function->name + "(" + args + ");\n\n" + body;
+        edits.add({tokens[function->start].offset, tokens[name].offset + tokens[name].text.size() - tokens[function->start].offset, head});
+        
+        std::string wrapper;
+        wrapper += "\n\n";
+        wrapper += std::string(function->exported ? "EXPORT " : "") + function->name + "(" + args + ")\n";
+        wrapper += "BEGIN\n";
+        wrapper += "  LOCAL " + cell + ";\n";
+        wrapper += "  IF " + guard + " THEN\n";
+        wrapper += "    RETURN " + body + "(" + args + ");\n";
+        wrapper += "  END;\n";
+        wrapper += "  IF SIZE(" + cache + ") == 0 THEN\n";
+        wrapper += "    " + cache + " := MAKELIST(\"\", " + cell + ", 1, " + std::to_string(cells) + ");\n";
+        wrapper += "  END;\n";
+        wrapper += "  " + cell + " := " + index + ";\n";
+        wrapper += "  IF TYPE(" + cache + "(" + cell + ")) == 2 THEN\n";
+        wrapper += "    " + cache + "(" + cell + ") := " + body + "(" + args + ");\n";
+        wrapper += "  END;\n";
+        wrapper += "  RETURN " + cache + "(" + cell + ");\n";
+        wrapper += "END;";
+        
+        const TToken& semicolon = tokens[function->end + 1];
+        edits.add({semicolon.offset + semicolon.text.size(), 0, wrapper});
+        
+        _memoized.push_back(request.name);
+    }
+    
+    return edits.empty() ? code : edits.apply(code);
+}
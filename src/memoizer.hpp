@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef MEMOIZER_HPP
+#define MEMOIZER_HPP
+
+#include <string>
+#include <vector>
+
+namespace pplplus {
+    /*
+     #pragma memo( Binom(0..60, 0..60), Fib(0..90) )
+     
+     Caches the results of pure functions whose arguments are whole numbers within the
+     given ranges, one range per parameter, so that recursive routines such as Binom
+     compute each value only once.
+     
+     Each function is renamed, without EXPORT, and a function of the original name put
+     in its place that looks the arguments up in a global list, calling the renamed
+     function only for a value not yet in the list. Arguments outside the ranges, or
+     that are not whole numbers, skip the list. The ranges may cover at most 9999
+     values, the most a list on the HP Prime can hold.
+     
+     A function that assigns to a global, or calls a built-in such as RANDOM or GETKEY
+     whose result can differ from call to call, is left alone and reported.
+     */
+    class Memoizer {
+    public:
+        typedef struct TRange {
+            long low;
+            long high;
+        } TRange;
+        
+        typedef struct TRequest {
+            std::string name;
+            std::vector<TRange> ranges;
+        } TRequest;
+        
+        typedef struct TSkipped {
+            std::string name;
+            std::string reason;
+        } TSkipped;
+        
+        static bool isMemoPragma(const std::string& str);
+        
+        // Adds the functions the #pragma memo names, false if it is not valid.
+        bool addPragma(const std::string& str);
+        
+        bool empty(void) const {
+            return _requests.empty();
+        }
+        
+        std::string memoize(const std::string& code);
+        
+        // Names of the functions memoized by the last call to memoize.
+        const std::vector<std::string>& memoized(void) const {
+            return _memoized;
+        }
+        
+        // Functions named by a #pragma memo that the last call to memoize left alone.
+        const std::vector<TSkipped>& skipped(void) const {
+            return _skipped;
+        }
+        
+    private:
+        std::vector<TRequest> _requests;
+        std::vector<std::string> _memoized;
+        std::vector<TSkipped> _skipped;
+    };
+}
+
+#endif // MEMOIZER_HPP
@@ -0,0 +1,261 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "minifier.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <cctype>
+
+using pplplus::Minifier;
+using pplplus::Lexer;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+// MARK: - Names
+
+static std::string lowercased(const std::string& str) {
+    std::string result = str;
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return std::tolower(c); });
+    return result;
+}
+
+/*
+ Short names that must never be used for a renamed variable, compared in lowercase.
+ Besides the keywords this covers constants such as e and i, short built-in functions
+ and the system variables C0-C9, G0-G9, L0-L9, M0-M9 and Z0-Z9.
+ */
+static bool isReserved(const std::string& name) {
+    static const std::unordered_set<std::string> reserved = {
+        "e", "i", "pi", "ln", "ip", "fp", "im", "re", "sq", "ans",
+        "abs", "max", "min", "log", "exp", "sin", "cos", "tan", "det", "arg", "cas",
+        "begin", "end", "return", "local", "export", "key", "view", "const",
+        "if", "then", "else", "iferr", "case", "default",
+        "for", "from", "to", "downto", "step", "do", "while", "repeat", "until",
+        "break", "continue", "and", "or", "not", "xor", "mod", "div"
+    };
+    
+    if (reserved.contains(name)) return true;
+    if (name.size() == 2 && std::isdigit(static_cast<unsigned char>(name[1]))) {
+        return std::string("cglmz").find(name[0]) != std::string::npos;
+    }
+    return false;
+}
+
+// The n-th name in order of length: a-z, then a letter followed by a letter or digit, and so on.
+static std::string generatedName(size_t n) {
+    static const std::string first = "abcdefghijklmnopqrstuvwxyz";
+    static const std::string rest = "abcdefghijklmnopqrstuvwxyz0123456789";
+    
+    if (n < first.size()) return std::string(1, first[n]);
+    n -= first.size();
+    
+    std::string name;
+    size_t count = first.size() * rest.size();
+    size_t length = 2;
+    while (n >= count) {
+        n -= count;
+        count *= rest.size();
+        length++;
+    }
+    
+    name.resize(length);
+    for (size_t i = length - 1; i > 0; i--) {
+        name[i] = rest[n % rest.size()];
+        n /= rest.size();
+    }
+    name[0] = first[n];
+    return name;
+}
+
+// An identifier that names a variable, rather than a keyword or a member such as the x in P.x
+static bool isVariable(const std::vector<TToken>& tokens, size_t i) {
+    if (tokens[i].type != Type::Identifier || Lexer::isKeyword(tokens[i].text)) return false;
+    return i == 0 || !Lexer::is(tokens[i - 1], Type::Operator, ".");
+}
+
+// MARK: - Renaming
+
+void Minifier::rename(std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    // Declared names and the index at which each is declared.
+    std::map<std::string, size_t> declared;
+    
+    if (!function.exported) {
+        int depth = 0;
+        for (size_t i = function.params; i < function.begin; i++) {
+            if (Lexer::is(tokens[i], Type::Operator, "(")) depth++;
+            if (Lexer::is(tokens[i], Type::Operator, ")")) depth--;
+            if (depth == 1 && isVariable(tokens, i)) declared.emplace(tokens[i].text, function.params);
+        }
+    }
+    
+    for (size_t i = function.begin; i < function.end; i++) {
+        if (!Lexer::is(tokens[i], Type::Identifier, "LOCAL")) continue;
+        
+        // LOCAL a, b := expression, c;
+        size_t j = i + 1;
+        while (j < function.end) {
+            if (isVariable(tokens, j)) declared.emplace(tokens[j].text, j);
+            
+            int depth = 0;
+            for (; j < function.end; j++) {
+                const std::string& text = tokens[j].text;
+                if (tokens[j].type != Type::Operator) continue;
+                if (text == "(" || text == "[" || text == "{") depth++;
+                if (text == ")" || text == "]" || text == "}") depth--;
+                if (depth == 0 && (text == "," || text == ";")) break;
+            }
+            if (j >= function.end || tokens[j].text == ";") break;
+            j++;
+        }
+        i = j;
+    }
+    
+    if (declared.empty()) return;
+    
+    std::unordered_map<std::string, size_t> uses;
+    std::unordered_map<std::string, size_t> firstUse;
+    std::unordered_set<std::string> forbidden;
+    std::unordered_set<std::string> quoted;
+    
+    for (size_t i = function.params; i <= function.end && i < tokens.size(); i++) {
+        if (tokens[i].type == Type::String) {
+            for (std::string_view word : Lexer::words(tokens[i].text)) quoted.emplace(word);
+        }
+        if (!isVariable(tokens, i)) continue;
+        
+        const std::string& text = tokens[i].text;
+        if (uses[text]++ == 0) firstUse[text] = i;
+        forbidden.insert(lowercased(text));
+    }
+    
+    std::vector<std::string> candidates;
+    for (const auto& [name, index] : declared) {
+        // Used before its declaration, so the earlier uses refer to a global.
+        if (firstUse[name] < index) continue;
+        if (quoted.contains(name)) continue;
+        
+        candidates.push_back(name);
+    }
+    
+    // The most used names get the shortest replacements.
+    std::stable_sort(candidates.begin(), candidates.end(), [&](const std::string& a, const std::string& b) {
+        if (uses[a] != uses[b]) return uses[a] > uses[b];
+        return firstUse[a] < firstUse[b];
+    });
+    
+    std::unordered_map<std::string, std::string> replacements;
+    size_t n = 0;
+    for (const std::string& name : candidates) {
+        std::string replacement;
+        do {
+            replacement = generatedName(n++);
+        } while (forbidden.contains(replacement) || isReserved(replacement));
+        
+        // Nothing to gain, keep the name and reuse the replacement for the next one.
+        if (replacement.size() >= name.size()) {
+            n--;
+            continue;
+        }
+        
+        replacements[name] = replacement;
+        _renames.push_back({function.name, name, replacement});
+    }
+    
+    if (replacements.empty()) return;
+    
+    for (size_t i = function.params; i <= function.end && i < tokens.size(); i++) {
+        if (!isVariable(tokens, i)) continue;
+        auto it = replacements.find(tokens[i].text);
+        if (it != replacements.end()) tokens[i].text = it->second;
+    }
+}
+
+// MARK: - Output
+
+std::string Minifier::minify(const std::string& code) {
+    static const std::unordered_map<std::string, std::string> operators = {
+        {">=", "≥"}, {"<=", "≤"}, {"<>", "≠"}
+    };
+    
+    std::vector<TToken> tokens = Lexer::tokenize(code);
+    
+    _renames.clear();
+    if (renameIdentifiers) {
+        for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+            rename(tokens, function);
+        }
+    }
+    
+    std::string output;
+    output.reserve(code.size());
+    
+    const TToken* previous = nullptr;
+    for (TToken& token : tokens) {
+        if (token.type == Type::Directive) {
+            if (!output.empty() && output.back() != '\n') output += '\n';
+            output += token.text;
+            output += '\n';
+            previous = nullptr;
+            continue;
+        }
+        
+        if (token.type == Type::Operator) {
+            auto it = operators.find(token.text);
+            if (it != operators.end()) token.text = it->second;
+        }
+        if (Lexer::is(token, Type::Identifier, "FROM")) {
+            token.type = Type::Operator;
+            token.text = ":=";
+        }
+        
+        if (previous) {
+            if (token.newline && previous->text != ";") {
+                // Line breaks that do not follow a statement are kept, as after `\` or before BEGIN.
+                output += '\n';
+            } else if (Lexer::separated(*previous, token)) {
+                output += token.newline ? '\n' : ' ';
+            }
+        }
+        
+        output += token.text;
+        previous = &token;
+    }
+    
+    return output;
+}
+
+bool Minifier::saveMap(const std::filesystem::path& path) const {
+    std::ofstream os(path);
+    if (!os.is_open()) return false;
+    
+    for (const TRename& rename : _renames) {
+        os << rename.function << ": " << rename.original << " -> " << rename.renamed << "\n";
+    }
+    return true;
+}
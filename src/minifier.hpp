@@ -0,0 +1,72 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef MINIFIER_HPP
+#define MINIFIER_HPP
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "lexer.hpp"
+
+namespace pplplus {
+    /*
+     Compresses translated PPL by working over its tokens.
+     
+     Comments and all whitespace that is not needed to keep two tokens apart are
+     removed, >=, <= and <> become ≥, ≤ and ≠, and FOR ... FROM becomes FOR ... :=.
+     Variables declared with LOCAL inside a function, and the parameters of functions
+     that are not exported, are renamed to the shortest names that are safe within the
+     function. A name that also appears inside a string in the function, for example
+     for use with EXPR, is left as it is.
+     */
+    class Minifier {
+    public:
+        typedef struct TRename {
+            std::string function;
+            std::string original;
+            std::string renamed;
+        } TRename;
+        
+        bool renameIdentifiers = true;
+        
+        std::string minify(const std::string& code);
+        
+        // Renamings made by the last call to minify.
+        const std::vector<TRename>& renames(void) const {
+            return _renames;
+        }
+        
+        // Writes the renamings as `function: original -> renamed` lines.
+        bool saveMap(const std::filesystem::path& path) const;
+        
+    private:
+        std::vector<TRename> _renames;
+        
+        void rename(std::vector<Lexer::TToken>& tokens, const Lexer::TFunction& function);
+    };
+}
+
+#endif // MINIFIER_HPP
@@ -28,6 +28,8 @@
 #include <string>
 #include <sstream>
 #include <unordered_set>
+#include <algorithm>
+#include <cctype>
 
 namespace pplplus::pascal {
     static std::string lowercased(const std::string& s) {
@@ -304,8 +306,10 @@ namespace pplplus::pascal {
 
     static std::string removePascalTypes(const std::string& input)
     {
-        std::regex re(R"(:\s*[^;]+;)");
-        return std::regex_replace(input, re, ";");
+        // A type annotation follows a declared name, as in `var a, b: Integer;`. Neither `:=`
+        // nor the width of an integer such as `#FF:64h` is one.
+        std::regex re(R"((^|[^#\w])([A-Za-z_]\w*)\s*:(?!=)\s*[A-Za-z_][\w ]*;)");
+        return std::regex_replace(input, re, "$1$2;");
     }
 
     static std::string convertPascalToPPL(const std::string& input)
@@ -346,4 +350,56 @@ namespace pplplus::pascal {
         
         return output;
     }
+    
+    static bool containsCaseInsensitive(std::string_view s, std::string_view word) {
+        auto it = std::search(s.begin(), s.end(), word.begin(), word.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        });
+        return it != s.end();
+    }
+    
+    /*
+     Whether the code has a type annotation, as removed by removePascalTypes: a name followed
+     by `:` but not `:=`, outside of a string and not the width of an integer such as `#FF:64h`.
+     */
+    static bool hasTypeAnnotation(std::string_view code) {
+        auto isWord = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+        bool quoted = false;
+        
+        for (size_t i = 0; i < code.size(); i++) {
+            char c = code[i];
+            if (c == '\n') quoted = false;
+            if (quoted && c == '\\') {
+                i++;
+                continue;
+            }
+            if (c == '"') quoted = !quoted;
+            if (quoted || c != ':' || (i + 1 < code.size() && code[i + 1] == '=')) continue;
+            
+            size_t end = i;
+            while (end > 0 && code[end - 1] == ' ') end--;
+            size_t start = end;
+            while (start > 0 && isWord(code[start - 1])) start--;
+            if (start == end || std::isdigit(static_cast<unsigned char>(code[start]))) continue;
+            if (start > 0 && code[start - 1] == '#') continue;
+            return true;
+        }
+        return false;
+    }
+    
+    bool requiresConversion(std::string_view code) {
+        if (code.empty()) return false;
+        
+        // convertPascalCase terminates every line, including the last, with a newline.
+        if (code.back() != '\n') return true;
+        
+        if (hasTypeAnnotation(code)) return true;
+        if (code.find("case ") != std::string_view::npos) return true;
+        
+        for (const char* word : {"interface", "implementation", "function", "procedure"}) {
+            if (containsCaseInsensitive(code, word)) return true;
+        }
+        
+        return false;
+    }
 }
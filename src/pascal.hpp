@@ -25,8 +25,16 @@
 #include "aliases.hpp"
 #include "singleton.hpp"
 
+#include <string_view>
+
 namespace pplplus::pascal {
     std::string convertPascalSyntax(const std::string &code);
+    
+    /*
+     Returns false when convertPascalSyntax is known to leave the code unchanged,
+     allowing the caller to skip the conversion and the copy it makes.
+     */
+    bool requiresConversion(std::string_view code);
 }
 
 
@@ -0,0 +1,340 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "peephole.hpp"
+#include "lexer.hpp"
+#include "expression.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <unordered_set>
+
+using pplplus::Peephole;
+using pplplus::Lexer;
+using pplplus::Expression;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 16
+
+static bool isBooleanOperator(const TToken& token) {
+    static const std::unordered_set<std::string> comparisons = {
+        "==", "=", "<", ">", "<=", ">=", "<>", "≤", "≥", "≠"
+    };
+    if (token.type == Type::Identifier) {
+        return token.text == "AND" || token.text == "OR" || token.text == "XOR" || token.text == "NOT";
+    }
+    return token.type == Type::Operator && comparisons.contains(token.text);
+}
+
+// A variable on its own, rather than a call or a list lookup.
+static bool isVariable(const std::vector<TToken>& tokens, size_t i) {
+    if (!Lexer::isName(tokens[i])) return false;
+    if (i > 0 && Lexer::isOperator(tokens[i - 1], ".")) return false;
+    return i + 1 >= tokens.size() || !(Lexer::isOperator(tokens[i + 1], "(") || Lexer::isOperator(tokens[i + 1], "["));
+}
+
+static size_t skip(const std::vector<TToken>& tokens, size_t i, std::string_view text) {
+    return i < tokens.size() && Lexer::isOperator(tokens[i], text) ? i + 1 : i;
+}
+
+/*
+ True if the result of tokens first to last is 1 or 0, as it is when a comparison or
+ logical operator is outside any brackets, since these bind more loosely than the rest.
+ */
+static bool isBoolean(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    if (first < last && Lexer::isOperator(tokens[first], "(") && Lexer::closing(tokens, first, last + 1) == last) {
+        return isBoolean(tokens, first + 1, last - 1);
+    }
+    
+    int depth = 0;
+    for (size_t i = first; i <= last; i++) {
+        if (Lexer::isOpening(tokens[i])) depth++;
+        if (Lexer::isClosing(tokens[i])) depth--;
+        if (depth == 0 && isBooleanOperator(tokens[i])) return true;
+    }
+    return false;
+}
+
+static Lexer::TEdit replace(const std::vector<TToken>& tokens, size_t first, size_t last, const std::string& text) {
+    size_t start = tokens[first].offset;
+    return {start, tokens[last].offset + tokens[last].text.size() - start, text};
+}
+
+// MARK: - Rules
+
+// x^2 and x² to x*x
+static void square(const std::vector<TToken>& tokens, size_t first, size_t last, Edits& edits, size_t& count) {
+    for (size_t i = first + 1; i + 1 <= last; i++) {
+        if (!isVariable(tokens, i)) continue;
+        
+        size_t end;
+        if (Lexer::isOperator(tokens[i + 1], "²")) {
+            end = i + 1;
+        } else if (i + 2 <= last && Lexer::isOperator(tokens[i + 1], "^") && Lexer::is(tokens[i + 2], Type::Number, "2")) {
+            end = i + 2;
+        } else {
+            continue;
+        }
+        if (end + 1 <= last && (Lexer::isOperator(tokens[end + 1], "^") || Lexer::isOperator(tokens[end + 1], "²"))) continue;
+        
+        // Only a + or a * to the left leaves x*x grouped as x^2 was, and a - only if it subtracts.
+        const TToken& left = tokens[i - 1];
+        bool grouped = !(left.type == Type::Operator && (left.text == "/" || left.text == "^" || left.text == "-")) &&
+        !Lexer::isIdentifier(left, "MOD") && !Lexer::isIdentifier(left, "DIV");
+        if (Lexer::isOperator(left, "-") && i >= 2 && Lexer::isOperand(tokens[i - 2])) grouped = true;
+        
+        std::string text = tokens[i].text + "*" + tokens[i].text;
+        if (edits.add(replace(tokens, i, end, grouped ? text : "(" + text + ")"))) count++;
+        i = end;
+    }
+}
+
+// A power of two written as a number, and the power.
+static bool powerOfTwo(const TToken& token, int& power) {
+    double value;
+    if (token.type != Type::Number || !Expression::number(token.text, value)) return false;
+    if (value < 2 || value > 9007199254740992.0 || value != std::floor(value)) return false;
+    int exponent;
+    if (std::frexp(value, &exponent) != 0.5) return false;
+    power = exponent - 1;
+    return true;
+}
+
+static bool isInteger(const TToken& token) {
+    return token.type == Type::Number && token.text.starts_with("#");
+}
+
+// BITAND(...) and the like, whose result is always an integer.
+static bool isBitwise(const TToken& token) {
+    return token.type == Type::Identifier && (token.text == "BITAND" || token.text == "BITOR" || token.text == "BITXOR" ||
+                                              token.text == "BITNOT" || token.text == "BITSL" || token.text == "BITSR");
+}
+
+// #3h*#4h to BITSL(#3h, 2) and #4h*BITAND(x, #Fh) to BITSL(BITAND(x, #Fh), 2), where both
+// operands are integers, as BITSL drops the fraction of a real. Division is left alone, since
+// / truncates toward zero and BITSR does not.
+static void shift(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last, Edits& edits, size_t& count) {
+    for (size_t i = first + 1; i + 1 <= last; i++) {
+        const TToken& op = tokens[i];
+        if (!Lexer::isOperator(op, "*")) continue;
+        
+        int power;
+        size_t begin, end;      // The whole product.
+        size_t operand, final;  // The other operand.
+        
+        if (isInteger(tokens[i + 1]) && powerOfTwo(tokens[i + 1], power)) {
+            begin = i - 1;
+            end = i + 1;
+            final = i - 1;
+            if (Lexer::isClosing(tokens[final])) {
+                begin = Lexer::opening(tokens, final);
+                if (begin == 0 || !isBitwise(tokens[begin - 1]) || !Lexer::isOperator(tokens[begin], "(")) continue;
+                begin--;
+            } else if (!isInteger(tokens[final])) {
+                continue;
+            }
+            operand = begin;
+        } else if (isInteger(tokens[i - 1]) && powerOfTwo(tokens[i - 1], power)) {
+            begin = i - 1;
+            operand = i + 1;
+            if (isBitwise(tokens[operand]) && operand + 1 <= last && Lexer::isOperator(tokens[operand + 1], "(")) {
+                final = Lexer::closing(tokens, operand + 1, last + 1);
+                if (final > last) continue;
+            } else if (isInteger(tokens[operand])) {
+                final = operand;
+            } else {
+                continue;
+            }
+            end = final;
+        } else {
+            continue;
+        }
+        if (begin <= first) continue;
+        
+        // Nothing that binds as tightly as * may take either side of the product away from it.
+        const TToken& left = tokens[begin - 1];
+        if (left.type == Type::Operator && (left.text == "*" || left.text == "/" || left.text == "^" || left.text == "." ||
+                                            (left.text == "-" && !Lexer::isOperand(tokens[begin - 2])))) continue;
+        if (Lexer::isIdentifier(left, "MOD") || Lexer::isIdentifier(left, "DIV")) continue;
+        if (end + 1 <= last && (Lexer::isOperator(tokens[end + 1], "^") || Lexer::isOperator(tokens[end + 1], "²"))) continue;
+        
+        std::ostringstream os;
+        os << "BITSL(" << Lexer::text(code, tokens, operand, final) << ", " << power << ")";
+        if (edits.add(replace(tokens, begin, end, os.str()))) count++;
+        i = end;
+    }
+}
+
+// RETURN 1 or RETURN 0, and its value.
+static bool returnsBit(const std::vector<TToken>& tokens, size_t i, size_t last, int& bit) {
+    if (i + 1 > last || !Lexer::isIdentifier(tokens[i], "RETURN") || tokens[i + 1].type != Type::Number) return false;
+    if (tokens[i + 1].text != "1" && tokens[i + 1].text != "0") return false;
+    bit = tokens[i + 1].text == "1";
+    return true;
+}
+
+// IF c THEN RETURN 1; ELSE RETURN 0; END; and IF c THEN RETURN 1; END; RETURN 0; to RETURN c;
+static void boolean(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last, Edits& edits, size_t& count) {
+    for (size_t i = first; i <= last; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "IF") || !Lexer::isStatementStart(tokens, i)) continue;
+        
+        size_t then = i + 1;
+        while (then <= last && !Lexer::isIdentifier(tokens[then], "THEN") && !Lexer::isBlockStart(tokens[then])) then++;
+        if (then > last || !Lexer::isIdentifier(tokens[then], "THEN") || then == i + 1) continue;
+        if (!isBoolean(tokens, i + 1, then - 1)) continue;
+        
+        int a, b;
+        if (!returnsBit(tokens, then + 1, last, a)) continue;
+        size_t j = skip(tokens, then + 3, ";");
+        
+        if (j <= last && Lexer::isIdentifier(tokens[j], "ELSE")) {
+            if (!returnsBit(tokens, j + 1, last, b)) continue;
+            j = skip(tokens, j + 3, ";");
+            if (j > last || !Lexer::isIdentifier(tokens[j], "END")) continue;
+        } else if (j <= last && Lexer::isIdentifier(tokens[j], "END")) {
+            j = skip(tokens, j + 1, ";");
+            if (!returnsBit(tokens, j, last, b)) continue;
+            j++;
+        } else {
+            continue;
+        }
+        if (a == b) continue;
+        
+        size_t end = j + 1 <= last && Lexer::isOperator(tokens[j + 1], ";") ? j + 1 : j;
+        std::string condition(Lexer::text(code, tokens, i + 1, then - 1));
+        std::string text = a ? "RETURN " + condition : "RETURN NOT(" + condition + ")";
+        if (Lexer::isOperator(tokens[end], ";")) text += ";";
+        
+        if (edits.add(replace(tokens, i, end, text))) count++;
+        i = end;
+    }
+}
+
+// A statement name := name; giving its end, or 0.
+static size_t copy(const std::vector<TToken>& tokens, size_t i, size_t last) {
+    if (i + 3 > last || !Lexer::isStatementStart(tokens, i) || !isVariable(tokens, i)) return 0;
+    if (!Lexer::isOperator(tokens[i + 1], ":=") || !isVariable(tokens, i + 2)) return 0;
+    return Lexer::isOperator(tokens[i + 3], ";") ? i + 3 : 0;
+}
+
+// x := x; and the second of a := b; b := a;
+static void copies(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last, Edits& edits, size_t& count) {
+    for (size_t i = first; i <= last; i++) {
+        size_t end = copy(tokens, i, last);
+        if (!end) continue;
+        
+        if (tokens[i].text == tokens[i + 2].text) {
+            if (edits.add(Lexer::erase(code, tokens, i, end))) count++;
+            i = end;
+            continue;
+        }
+        
+        size_t next = copy(tokens, end + 1, last);
+        if (next && tokens[end + 1].text == tokens[i + 2].text && tokens[end + 3].text == tokens[i].text) {
+            if (edits.add(Lexer::erase(code, tokens, end + 1, next))) count++;
+            i = next;
+        }
+    }
+}
+
+// NOT NOT c to c
+static void doubleNot(const std::vector<TToken>& tokens, size_t first, size_t last, Edits& edits, size_t& count) {
+    for (size_t i = first + 1; i + 2 <= last; i++) {
+        if (!Lexer::isIdentifier(tokens[i], "NOT") || !Lexer::isIdentifier(tokens[i + 1], "NOT")) continue;
+        
+        // Where only whether the value is true matters.
+        const TToken& left = tokens[i - 1];
+        bool truth = Lexer::isIdentifier(left, "IF") || Lexer::isIdentifier(left, "WHILE") || Lexer::isIdentifier(left, "UNTIL") ||
+        Lexer::isIdentifier(left, "AND") || Lexer::isIdentifier(left, "OR") || Lexer::isIdentifier(left, "XOR") || Lexer::isIdentifier(left, "NOT");
+        
+        if (!truth) {
+            // The operand runs to the first AND, OR or XOR, or the end of the expression.
+            size_t end = i + 2;
+            int depth = 0;
+            for (; end <= last; end++) {
+                const TToken& token = tokens[end];
+                if (Lexer::isOpening(token)) depth++;
+                if (Lexer::isClosing(token) && --depth < 0) break;
+                if (depth > 0) continue;
+                if (Lexer::isOperator(token, ";") || Lexer::isOperator(token, ",") || Lexer::isIdentifier(token, "AND") || Lexer::isIdentifier(token, "OR") ||
+                    Lexer::isIdentifier(token, "XOR") || (token.type == Type::Identifier && Lexer::isKeyword(token.text) && token.text != "NOT" &&
+                                                   token.text != "MOD" && token.text != "DIV")) break;
+            }
+            truth = end > i + 2 && isBoolean(tokens, i + 2, end - 1);
+        }
+        if (!truth) continue;
+        
+        if (edits.add({tokens[i].offset, tokens[i + 2].offset - tokens[i].offset, ""})) count++;
+        i++;
+    }
+}
+
+// MARK: - Public Methods
+
+bool Peephole::select(const std::string& names) {
+    rules = 0;
+    std::istringstream is(names);
+    std::string name;
+    while (std::getline(is, name, ',')) {
+        if (name == "square") rules |= Square;
+        else if (name == "shift") rules |= Shift;
+        else if (name == "boolean") rules |= Boolean;
+        else if (name == "copy") rules |= Copy;
+        else if (name == "not") rules |= Not;
+        else if (name == "all") rules |= All;
+        else return false;
+    }
+    return true;
+}
+
+std::string Peephole::optimize(const std::string& code) {
+    _report = TReport();
+    std::string result = code;
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        Edits edits;
+        
+        for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+            if (function.end >= tokens.size()) continue;
+            size_t first = function.begin + 1;
+            size_t last = function.end - 1;
+            if (first > last) continue;
+            
+            if (rules & Boolean) boolean(result, tokens, first, last, edits, _report.boolean);
+            if (rules & Copy) copies(result, tokens, first, last, edits, _report.copy);
+            if (rules & Not) doubleNot(tokens, first, last, edits, _report.not_);
+            if (rules & Square) square(tokens, first, last, edits, _report.square);
+            if (rules & Shift) shift(result, tokens, first, last, edits, _report.shift);
+        }
+        
+        if (edits.empty()) break;
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
@@ -0,0 +1,80 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PEEPHOLE_HPP
+#define PEEPHOLE_HPP
+
+#include <string>
+
+namespace pplplus {
+    /*
+     Rewrites small patterns in the generated PPL into forms the HP Prime runs faster.
+     
+     square     x^2 or x² becomes x*x.
+     shift      Multiplying an integer, such as #FFh or the result of BITAND, by a power
+                of two becomes BITSL.
+     boolean    IF c THEN RETURN 1; ELSE RETURN 0; END; becomes RETURN c; where c is a
+                comparison or a logical expression, and so already 1 or 0.
+     copy       x := x; is removed, as is b := a; straight after a := b;.
+     not        NOT NOT c becomes c where only whether c is true matters, such as in the
+                condition of an IF, or where c is a comparison.
+     
+     Each rule can be turned on or off, and a count kept of the rewrites it made.
+     */
+    class Peephole {
+    public:
+        enum Rule : unsigned {
+            Square = 1,
+            Shift = 2,
+            Boolean = 4,
+            Copy = 8,
+            Not = 16,
+            All = 31
+        };
+        
+        typedef struct TReport {
+            size_t square = 0;
+            size_t shift = 0;
+            size_t boolean = 0;
+            size_t copy = 0;
+            size_t not_ = 0;
+        } TReport;
+        
+        unsigned rules = All;
+        
+        // Sets rules from a comma separated list of rule names, false if a name is unknown.
+        bool select(const std::string& names);
+        
+        std::string optimize(const std::string& code);
+        
+        const TReport& report(void) const {
+            return _report;
+        }
+        
+    private:
+        TReport _report;
+    };
+}
+
+#endif // PEEPHOLE_HPP
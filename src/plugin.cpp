@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "plugin.hpp"
+#include "plugin_abi.h"
+
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+static std::mutex mutex;
+
+// Add-ons are not required to be reentrant, so conversions run one at a time.
+static std::mutex convertMutex;
+
+// Add-on libraries by command, nullptr when the command has no usable library.
+static std::map<std::string, const pplplus_addon_t*> libraries;
+
+static std::filesystem::path libraryPath(const std::string& command)
+{
+    std::filesystem::path dir = tool::executableDir();
+#if defined(_WIN32)
+    return dir / (command + ".dll");
+#elif defined(__APPLE__)
+    return dir / ("lib" + command + ".dylib");
+#else
+    return dir / ("lib" + command + ".so");
+#endif
+}
+
+static const pplplus_addon_t* load(const std::string& command)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = libraries.find(command);
+    if (it != libraries.end()) return it->second;
+    
+    const pplplus_addon_t* addon = nullptr;
+    std::filesystem::path path = libraryPath(command);
+    
+    if (std::filesystem::exists(path)) {
+#if defined(_WIN32)
+        HMODULE handle = LoadLibraryW(path.wstring().c_str());
+        auto entry = handle ? reinterpret_cast<pplplus_addon_fn>(GetProcAddress(handle, "pplplus_addon")) : nullptr;
+#else
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        auto entry = handle ? reinterpret_cast<pplplus_addon_fn>(dlsym(handle, "pplplus_addon")) : nullptr;
+#endif
+        if (entry) addon = entry();
+        if (addon && (addon->abiVersion != PPLPLUS_ADDON_ABI_VERSION || !addon->convert || !addon->release)) {
+            addon = nullptr;
+        }
+        // Libraries stay loaded for the lifetime of the process.
+    }
+    
+    libraries[command] = addon;
+    return addon;
+}
+
+bool plugin::available(const std::string& command)
+{
+    return load(command) != nullptr;
+}
+
+long plugin::build(const std::string& command)
+{
+    const pplplus_addon_t* addon = load(command);
+    return addon ? addon->build : -1;
+}
+
+tool::result_t plugin::convert(const std::string& command, const std::filesystem::path& path)
+{
+    tool::result_t result{};
+    
+    const pplplus_addon_t* addon = load(command);
+    if (!addon) {
+        result.exitCode = -1;
+        result.err = "no add-on library for " + command;
+        return result;
+    }
+    
+    std::ifstream is(path, std::ios::in | std::ios::binary);
+    if (!is.is_open()) {
+        result.exitCode = -1;
+        result.err = "unable to read " + path.filename().string();
+        return result;
+    }
+    std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    
+    char* output = nullptr;
+    size_t length = 0;
+    std::string filename = path.string();
+    
+    std::lock_guard<std::mutex> lock(convertMutex);
+    result.exitCode = addon->convert(filename.c_str(), reinterpret_cast<const unsigned char*>(data.data()), data.size(), &output, &length);
+    if (output) {
+        (result.exitCode == 0 ? result.out : result.err).assign(output, length);
+        addon->release(output);
+    }
+    
+    return result;
+}
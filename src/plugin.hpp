@@ -1,6 +1,8 @@
 // The MIT License (MIT)
 //
-// Copyright (c) 2023-2025 Insoft.
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -22,14 +24,21 @@
 
 #pragma once
 
-#include <iostream>
-#include <regex>
-#include <list>
-#include <sstream>
 #include <string>
-#include <unordered_set>
-#include <cctype>
+#include <filesystem>
+
+#include "tool.hpp"
 
-namespace reformat {
-    std::string prgm(const std::string& s);
+namespace plugin {
+    // True if the add-on command is available as an in-process library.
+    bool available(const std::string& command);
+    
+    // Build number reported by the add-on library, or -1 if there is none.
+    long build(const std::string& command);
+    
+    /*
+     Converts the file using the add-on library for command. The result mirrors
+     tool::runTool, with an exit code of -1 if the library could not be loaded.
+     */
+    tool::result_t convert(const std::string& command, const std::filesystem::path& path);
 }
@@ -0,0 +1,80 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ In-process add-on interface.
+ 
+ An add-on may be built as a shared library as well as an executable. ppl+ looks for
+ lib<command>.dylib (macOS), lib<command>.so (Linux) or <command>.dll (Windows) next
+ to its own executable, and only starts the <command> executable when no library is
+ found or the library reports a different ABI version.
+ 
+ The library exports a single C function, pplplus_addon, returning a description of
+ the add-on. This header is plain C so that add-ons are not tied to the C++ runtime
+ ppl+ was built with.
+ */
+
+#ifndef plugin_abi_h
+#define plugin_abi_h
+
+#include <stddef.h>
+
+#define PPLPLUS_ADDON_ABI_VERSION 1
+
+#if defined(_WIN32)
+    #define PPLPLUS_ADDON_EXPORT __declspec(dllexport)
+#else
+    #define PPLPLUS_ADDON_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    /* Must be PPLPLUS_ADDON_ABI_VERSION. */
+    int abiVersion;
+    
+    /* Build number of the add-on, as printed by its --build option. */
+    long build;
+    
+    /*
+     Converts the contents of the file at filename into PPL, UTF-8 encoded. On success
+     0 is returned and *output points to the text. On failure a non-zero value is
+     returned and *output, if not NULL, points to an error message. In both cases
+     *output is released by calling release.
+     */
+    int (*convert)(const char* filename, const unsigned char* data, size_t size, char** output, size_t* length);
+    void (*release)(char* output);
+} pplplus_addon_t;
+
+typedef const pplplus_addon_t* (*pplplus_addon_fn)(void);
+
+PPLPLUS_ADDON_EXPORT const pplplus_addon_t* pplplus_addon(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* plugin_abi_h */
@@ -0,0 +1,308 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "reformatter.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+using pplplus::Reformatter;
+using pplplus::Lexer;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+enum class Block {
+    Begin,
+    Condition,  // IF ... before its THEN
+    If,
+    Header,     // FOR or WHILE ... before its DO
+    Loop,
+    Repeat,
+    Case,
+    Default,
+    Iferr
+};
+
+// FNV-1a over the tokens, including where whitespace came before them.
+static uint64_t hash(const std::vector<TToken>& tokens, size_t first, size_t last) {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](unsigned char c) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    };
+    
+    for (size_t i = first; i < last; i++) {
+        const TToken& token = tokens[i];
+        mix(static_cast<unsigned char>(token.type));
+        mix(token.space | token.newline << 1);
+        for (char c : token.text) mix(static_cast<unsigned char>(c));
+        mix(0);
+    }
+    return h;
+}
+
+static bool isKeyword(const TToken& token) {
+    return token.type == Type::Identifier && Lexer::isKeyword(token.text);
+}
+
+// Operators spaced out on both sides when binary, as in total := total - 10.
+static bool isBinary(const TToken& token) {
+    static const std::unordered_set<std::string> operators = {
+        ":=", "=", "==", "≠", "<", ">", "≤", "≥", "+", "-", "*", "/", "▶"
+    };
+    return token.type == Type::Operator && operators.contains(token.text);
+}
+
+// A token that can end an operand, after which an operator is binary rather than unary.
+static bool endsOperand(const TToken& token) {
+    if (token.type == Type::Number || token.type == Type::String) return true;
+    if (token.type == Type::Identifier) return !Lexer::isKeyword(token.text);
+    return Lexer::isClosing(token);
+}
+
+// Whether a space goes between tokens a and b, binary being true if a is a binary operator.
+static bool spaced(const TToken& a, const TToken& b, bool binary) {
+    if (b.text == "," || b.text == ";") return false;
+    if (a.text == "," || binary) return true;
+    if (isBinary(b) && endsOperand(a)) return true;
+    if (isKeyword(a) && !Lexer::isClosing(b)) return true;
+    if (isKeyword(b) && !Lexer::isOpening(a)) return true;
+    return Lexer::separated(a, b);
+}
+
+// MARK: - Formatting
+
+std::string Reformatter::format(std::vector<TToken>& tokens, size_t first, size_t last) const {
+    static const std::unordered_map<std::string, std::string> operators = {
+        {">=", "≥"}, {"<=", "≤"}, {"<>", "≠"}
+    };
+    
+    std::string output;
+    std::vector<Block> blocks;
+    int level = 0;
+    int depth = 0;
+    
+    const TToken* previous = nullptr;   // The last token on the current line.
+    bool binary = false;                // The previous token is a binary operator.
+    bool pending = false;               // A line break is due before the next token.
+    
+    auto breakLine = [&]() {
+        if (previous) pending = true;
+    };
+    
+    auto emit = [&](const TToken& token, int outdent = 0) {
+        if (pending) {
+            output += '\n';
+            previous = nullptr;
+            pending = false;
+        }
+        if (!previous) {
+            output.append(std::max(0, level - outdent) * indentation, ' ');
+        } else if (spaced(*previous, token, binary)) {
+            output += ' ';
+        }
+        output += token.text;
+        binary = previous && isBinary(token) && endsOperand(*previous);
+        previous = &token;
+    };
+    
+    auto open = [&](Block block) {
+        blocks.push_back(block);
+        level++;
+    };
+    
+    // Closes the innermost block, along with any IF or loop header left unfinished.
+    auto close = [&]() {
+        while (!blocks.empty() && (blocks.back() == Block::Condition || blocks.back() == Block::Header)) blocks.pop_back();
+        if (blocks.empty()) return;
+        blocks.pop_back();
+        level--;
+    };
+    
+    for (size_t i = first; i < last; i++) {
+        TToken& token = tokens[i];
+        Block top = blocks.empty() ? Block::Begin : blocks.back();
+        
+        if (token.type == Type::Directive) {
+            if (previous) output += '\n';
+            output += token.text;
+            output += '\n';
+            previous = nullptr;
+            pending = false;
+            continue;
+        }
+        
+        if (token.type == Type::Comment) {
+            if (token.newline) {
+                breakLine();
+                emit(token);
+            } else {
+                // Stays at the end of the statement it follows.
+                pending = false;
+                if (previous) output += ' ';
+                output += token.text;
+                previous = &token;
+                binary = false;
+            }
+            breakLine();
+            continue;
+        }
+        
+        if (token.type == Type::Operator) {
+            auto it = operators.find(token.text);
+            if (it != operators.end()) token.text = it->second;
+            
+            if (Lexer::isOpening(token)) depth++;
+            if (Lexer::isClosing(token)) depth--;
+            
+            emit(token);
+            if (token.text == ";" && depth <= 0) breakLine();
+            continue;
+        }
+        
+        if (token.type != Type::Identifier || !Lexer::isKeyword(token.text)) {
+            emit(token);
+            continue;
+        }
+        
+        const std::string& keyword = token.text;
+        
+        if (keyword == "BEGIN") {
+            breakLine();
+            emit(token);
+            open(Block::Begin);
+            breakLine();
+        } else if (keyword == "IF") {
+            emit(token);
+            blocks.push_back(Block::Condition);
+        } else if (keyword == "THEN" && top == Block::Condition) {
+            emit(token);
+            blocks.back() = Block::If;
+            level++;
+            breakLine();
+        } else if (keyword == "THEN" && top == Block::Iferr) {
+            breakLine();
+            emit(token, 1);
+            breakLine();
+        } else if (keyword == "ELSE") {
+            breakLine();
+            emit(token, 1);
+            breakLine();
+        } else if (keyword == "FOR" || keyword == "WHILE") {
+            emit(token);
+            blocks.push_back(Block::Header);
+        } else if (keyword == "DO" && top == Block::Header) {
+            emit(token);
+            blocks.back() = Block::Loop;
+            level++;
+            breakLine();
+        } else if (keyword == "REPEAT") {
+            emit(token);
+            open(Block::Repeat);
+            breakLine();
+        } else if (keyword == "UNTIL" && top == Block::Repeat) {
+            close();
+            breakLine();
+            emit(token);
+        } else if (keyword == "CASE") {
+            emit(token);
+            open(Block::Case);
+            breakLine();
+        } else if (keyword == "DEFAULT" && top == Block::Case) {
+            breakLine();
+            emit(token);
+            open(Block::Default);
+            breakLine();
+        } else if (keyword == "IFERR") {
+            emit(token);
+            open(Block::Iferr);
+            breakLine();
+        } else if (keyword == "END") {
+            if (top == Block::Default) close();
+            close();
+            breakLine();
+            emit(token);
+        } else {
+            emit(token);
+        }
+    }
+    
+    if (previous) output += '\n';
+    return output;
+}
+
+// MARK: - Caching
+
+std::string Reformatter::reformat(const std::string& code) {
+    std::vector<TToken> tokens = Lexer::tokenize(code, true);
+    
+    // Only the parts of this program are kept, so the cache never outgrows it.
+    std::unordered_map<uint64_t, std::string> cache;
+    std::string output;
+    output.reserve(code.size());
+    
+    _parts = 0;
+    _reused = 0;
+    
+    // A blank line follows each function, ahead of whatever comes next.
+    bool gap = false;
+    
+    auto part = [&](size_t first, size_t last) {
+        if (first >= last) return;
+        if (gap) output += '\n';
+        gap = false;
+        _parts++;
+        
+        uint64_t key = hash(tokens, first, last);
+        auto it = _cache.find(key);
+        if (it != _cache.end()) {
+            _reused++;
+            output += it->second;
+            cache.emplace(key, it->second);
+            return;
+        }
+        
+        std::string text = format(tokens, first, last);
+        output += text;
+        cache.emplace(key, std::move(text));
+    };
+    
+    size_t next = 0;
+    for (const Lexer::TFunction& function : Lexer::functions(tokens)) {
+        // The END; closing the function, and any comment after it on the same line.
+        size_t end = std::min(function.end + 1, tokens.size());
+        if (end < tokens.size() && Lexer::is(tokens[end], Type::Operator, ";")) end++;
+        if (end < tokens.size() && tokens[end].type == Type::Comment && !tokens[end].newline) end++;
+        
+        part(next, function.start);
+        part(function.start, end);
+        gap = true;
+        next = end;
+    }
+    part(next, tokens.size());
+    
+    _cache = std::move(cache);
+    return output;
+}
@@ -0,0 +1,66 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REFORMATTER_HPP
+#define REFORMATTER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "lexer.hpp"
+
+namespace pplplus {
+    /*
+     Lays out PPL with one statement per line, indenting the body of every block.
+     
+     The program is split into its top-level functions and the code between them, and
+     the formatted text of each part is kept against a hash of its tokens. Formatting
+     the same program again, as in watch mode, only formats the parts that changed.
+     */
+    class Reformatter {
+    public:
+        int indentation = 2;
+        
+        std::string reformat(const std::string& code);
+        
+        // Parts of the program formatted by the last call to reformat, and how many of them came from the cache.
+        size_t parts(void) const {
+            return _parts;
+        }
+        size_t reused(void) const {
+            return _reused;
+        }
+        
+    private:
+        std::unordered_map<uint64_t, std::string> _cache;
+        size_t _parts = 0;
+        size_t _reused = 0;
+        
+        std::string format(std::vector<Lexer::TToken>& tokens, size_t first, size_t last) const;
+    };
+}
+
+#endif // REFORMATTER_HPP
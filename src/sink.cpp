@@ -0,0 +1,109 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sink.hpp"
+
+#include <regex>
+#include <cctype>
+
+using pplplus::OutputSink;
+
+static std::string removeUses(const std::string& str) {
+    static const std::regex re(R"(\buses\s+([^;]+);)");
+    
+    if (str.find("uses") == std::string::npos) return str;
+    return std::regex_replace(str, re, "\n");
+}
+
+// A `uses` clause names a few units, so text that runs on for longer without a `;`, such as
+// the rest of a comment, is not held back as one.
+#define USES_LIMIT 4096
+
+static bool isWordStart(const std::string& str, size_t pos) {
+    return pos == 0 || !(std::isalnum(static_cast<unsigned char>(str[pos - 1])) || str[pos - 1] == '_');
+}
+
+/*
+ A `uses` clause that has not yet been terminated by a `;` may still grow once more
+ text arrives, so anything from the start of such a clause is held back, as is a `u`,
+ `us` or `use` at the very end that may turn out to begin one.
+ */
+static size_t completePrefixLength(const std::string& str) {
+    size_t pos = str.rfind("uses");
+    
+    while (pos != std::string::npos && str.size() - pos <= USES_LIMIT) {
+        bool spaceAfter = pos + 4 < str.size() && std::isspace(static_cast<unsigned char>(str[pos + 4]));
+        
+        if (isWordStart(str, pos) && (spaceAfter || pos + 4 == str.size())) {
+            if (str.find(';', pos) == std::string::npos) return pos;
+            break;
+        }
+        if (pos == 0) break;
+        pos = str.rfind("uses", pos - 1);
+    }
+    
+    for (size_t length = 3; length > 0; length--) {
+        if (str.size() >= length && str.ends_with(std::string_view("uses", length)) && isWordStart(str, str.size() - length)) {
+            return str.size() - length;
+        }
+    }
+    
+    return str.size();
+}
+
+OutputSink::OutputSink(Consumer consumer, size_t chunkSize) : _consumer(std::move(consumer)), _chunkSize(chunkSize) {
+    _buffer.reserve(chunkSize + chunkSize / 4);
+}
+
+OutputSink& OutputSink::operator+=(std::string_view str) {
+    _buffer.append(str);
+    if (_consumer && _buffer.size() >= _chunkSize) emit(false);
+    return *this;
+}
+
+OutputSink& OutputSink::operator+=(char c) {
+    _buffer += c;
+    if (_consumer && _buffer.size() >= _chunkSize) emit(false);
+    return *this;
+}
+
+void OutputSink::flush(void) {
+    if (_consumer) emit(true);
+}
+
+std::string OutputSink::str(void) {
+    return removeUses(_buffer);
+}
+
+void OutputSink::emit(bool final) {
+    size_t length = final ? _buffer.size() : completePrefixLength(_buffer);
+    if (length == 0) return;
+    
+    std::string chunk = removeUses(_buffer.substr(0, length));
+    _buffer.erase(0, length);
+    
+    if (chunk.empty()) return;
+    _consumer(chunk);
+    _written += chunk.size();
+}
@@ -0,0 +1,70 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef sink_hpp
+#define sink_hpp
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+namespace pplplus {
+    /*
+     Collects the translated program a line at a time.
+     
+     Without a consumer everything is kept in memory and returned by str(). With a
+     consumer, text is handed on in chunks of about chunkSize bytes as it arrives,
+     so the whole program never needs to be held at once. Pascal `uses` clauses are
+     removed from the text in both cases.
+     */
+    class OutputSink {
+    public:
+        typedef std::function<void(std::string_view chunk)> Consumer;
+        
+        OutputSink() = default;
+        explicit OutputSink(Consumer consumer, size_t chunkSize = 64 * 1024);
+        
+        OutputSink& operator+=(std::string_view str);
+        OutputSink& operator+=(char c);
+        
+        // Hands any remaining text to the consumer.
+        void flush(void);
+        
+        // Returns the text collected when no consumer is used.
+        std::string str(void);
+        
+        // Total number of bytes handed to the consumer so far.
+        size_t written(void) const { return _written; }
+        
+    private:
+        Consumer _consumer;
+        size_t _chunkSize = 0;
+        size_t _written = 0;
+        std::string _buffer;
+        
+        void emit(bool final);
+    };
+}
+
+#endif /* sink_hpp */
@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "source.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using pplplus::Source;
+
+Source::Source(const std::filesystem::path& path) {
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    
+    struct stat st;
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (regular && st.st_size > 0) {
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+            _mapping = mapping;
+            _data = static_cast<const char*>(mapping);
+            _size = st.st_size;
+        }
+    }
+    close(fd);
+    
+    if (_mapping || (regular && st.st_size == 0)) return;
+#endif
+    
+    // Fallback for streams such as /dev/stdin or platforms without mmap.
+    std::ifstream is(path, std::ios::in | std::ios::binary);
+    if (!is.is_open()) return;
+    
+    _text.assign((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    _data = _text.data();
+    _size = _text.size();
+}
+
+Source::Source(std::string&& text) : _text(std::move(text)) {
+    _data = _text.data();
+    _size = _text.size();
+}
+
+Source::~Source() {
+#if !defined(_WIN32)
+    if (_mapping) munmap(_mapping, _size);
+#endif
+}
+
+bool Source::getline(std::string_view& line) {
+    if (eof()) {
+        line = {};
+        return false;
+    }
+    
+    const char* begin = _data + _position;
+    const void* newline = memchr(begin, '\n', _size - _position);
+    size_t length = newline ? static_cast<const char*>(newline) - begin : _size - _position;
+    
+    line = std::string_view(begin, length);
+    _position += length + (newline ? 1 : 0);
+    return true;
+}
+
+bool Source::getline(std::string& line) {
+    std::string_view view;
+    bool result = getline(view);
+    line.assign(view);
+    return result;
+}
+
+bool Source::getLogicalLine(std::string_view& line, long& joined) {
+    joined = 0;
+    if (!getline(line)) return false;
+    
+    if (line.empty() || line.back() != '\\') return true;
+    
+    /*
+     Handle any escape lines `\` by continuing to read line joining them all up as one long line.
+     */
+    _joined.assign(line);
+    while (!_joined.empty() && _joined.back() == '\\') {
+        _joined.pop_back();
+        std::string_view next;
+        getline(next);
+        _joined.append(next);
+        joined++;
+        if (next.empty()) break;
+    }
+    
+    line = _joined;
+    return true;
+}
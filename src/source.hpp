@@ -0,0 +1,79 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef source_hpp
+#define source_hpp
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace pplplus {
+    /*
+     A read-only view of a source file.
+     
+     The file contents are memory-mapped where the platform allows it, so lines can be
+     handed out as `std::string_view`s into the mapping without copying. A line is only
+     copied when `\` continuation lines have to be joined up as one long line.
+     */
+    class Source {
+    public:
+        Source() = default;
+        explicit Source(const std::filesystem::path& path);
+        explicit Source(std::string&& text);
+        ~Source();
+        
+        Source(const Source&) = delete;
+        Source& operator=(const Source&) = delete;
+        
+        std::string_view view() const { return {_data, _size}; }
+        bool empty() const { return _size == 0; }
+        bool eof() const { return _position >= _size; }
+        
+        /*
+         Reads the next physical line, without the trailing newline, behaving like
+         std::getline: a final line without a newline is still returned, and false
+         is returned once all lines have been read.
+         */
+        bool getline(std::string_view& line);
+        bool getline(std::string& line);
+        
+        /*
+         Reads the next line, joining any lines ending with `\` onto it. The number of
+         extra physical lines consumed by the join is returned through joined.
+         */
+        bool getLogicalLine(std::string_view& line, long& joined);
+        
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+        size_t _position = 0;
+        
+        void* _mapping = nullptr;
+        std::string _text;
+        std::string _joined;
+    };
+}
+
+#endif /* source_hpp */
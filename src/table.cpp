@@ -0,0 +1,163 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "table.hpp"
+#include "calc.hpp"
+#include "common.hpp"
+
+#include <regex>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <unordered_map>
+
+using pplplus::Table;
+using pplplus::Calc;
+
+// The most values a table may have.
+#define TABLE_LIMIT 1000000
+
+static std::string format(double value) {
+    if (value == 0) return "0";
+    
+    std::ostringstream os;
+    os << std::setprecision(12) << value;
+    std::string s = os.str();
+    
+    size_t e = s.find('e');
+    if (e != std::string::npos) {
+        std::string exponent = s.substr(e + 1);
+        if (exponent.front() == '+') exponent.erase(0, 1);
+        s = s.substr(0, e) + "ᴇ" + exponent;
+    }
+    return s;
+}
+
+static std::string list(const std::vector<std::string>& items, size_t first, size_t last) {
+    std::string s = "{";
+    for (size_t i = first; i < last; i++) {
+        if (i > first) s += ",";
+        s += items[i];
+    }
+    return s + "}";
+}
+
+// MARK: - Public Methods
+
+bool Table::isTableDefinition(const std::string& str) {
+    return std::regex_search(str, std::regex(R"(^ *#table\b)"));
+}
+
+std::string Table::processTableDefinition(const std::string& str) {
+    std::smatch match;
+    std::regex re(R"(^ *#table +([A-Za-z_]\w*) *:= *(.+?) +for +([A-Za-z_]\w*) *= *(.+?) *\.\. *(.+?)(?: +step +(.+?))?(?: +(degrees|radians))?(?: +packed +(\d+))? *$)",
+                  std::regex_constants::icase);
+    
+    if (!std::regex_match(str, match, re)) {
+        std::cerr << MessageType::Error << "#table: expected 'NAME := expression for x = start .. end [step n]'\n";
+        return "";
+    }
+    
+    std::string name = match.str(1);
+    std::string expression = match.str(2);
+    std::string variable = match.str(3);
+    bool degrees = match[7].matched && std::tolower(match.str(7).front()) == 'd';
+    int bits = match[8].matched ? atoi(match.str(8).c_str()) : 0;
+    
+    double start, end, step = 1;
+    if (!Calc::evaluate(match.str(4), {}, start) || !Calc::evaluate(match.str(5), {}, end)) return "";
+    if (match[6].matched && !Calc::evaluate(match.str(6), {}, step)) return "";
+    
+    if (step == 0 || (end - start) / step < 0) {
+        std::cerr << MessageType::Error << "#table: " << name << " step of " << step << " never reaches " << end << "\n";
+        return "";
+    }
+    double count = std::floor((end - start) / step + 1e-9) + 1;
+    if (count > TABLE_LIMIT) {
+        std::cerr << MessageType::Error << "#table: " << name << " would have " << count << " values, more than " << TABLE_LIMIT << "\n";
+        return "";
+    }
+    if (bits && (bits > 32 || 64 % bits != 0)) {
+        std::cerr << MessageType::Error << "#table: " << name << " packed " << bits << " is not 1, 2, 4, 8, 16 or 32\n";
+        return "";
+    }
+    
+    std::vector<std::string> items;
+    uint64_t word = 0;
+    int packed = 0;
+    
+    std::unordered_map<std::string, double> variables;
+    for (size_t n = 0; n < static_cast<size_t>(count); n++) {
+        variables[variable] = start + n * step;
+        
+        double value;
+        if (!Calc::evaluate(expression, variables, value, degrees)) return "";
+        if (!std::isfinite(value)) {
+            std::cerr << MessageType::Error << "#table: " << name << " has no value for " << variable << " = "
+                      << format(variables[variable]) << "\n";
+            return "";
+        }
+        
+        if (!bits) {
+            items.push_back(format(value));
+            continue;
+        }
+        
+        if (value != std::floor(value) || value < -std::ldexp(1, bits - 1) || value >= std::ldexp(1, bits)) {
+            std::cerr << MessageType::Error << "#table: " << name << " value " << format(value) << " for " << variable << " = "
+                      << format(variables[variable]) << " does not fit in " << bits << " bits\n";
+            return "";
+        }
+        uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+        word |= (static_cast<uint64_t>(static_cast<int64_t>(value)) & mask) << (packed * bits);
+        
+        if (++packed == 64 / bits) {
+            std::ostringstream os;
+            os << "#" << std::uppercase << std::hex << word << ":64h";
+            items.push_back(os.str());
+            word = 0;
+            packed = 0;
+        }
+    }
+    if (packed) {
+        std::ostringstream os;
+        os << "#" << std::uppercase << std::hex << word << ":64h";
+        items.push_back(os.str());
+    }
+    
+    std::string s;
+    if (items.size() <= LIST_LIMIT) {
+        s = list(items, 0, items.size());
+    } else {
+        s = "{";
+        for (size_t first = 0; first < items.size(); first += LIST_LIMIT) {
+            if (first) s += ",";
+            s += list(items, first, std::min(first + LIST_LIMIT, items.size()));
+        }
+        s += "}";
+    }
+    
+    return "LOCAL " + name + " := " + s + ";\n";
+}
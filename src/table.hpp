@@ -0,0 +1,52 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef table_hpp
+#define table_hpp
+
+#include <string>
+
+namespace pplplus {
+    /*
+     #table NAME := expression for x = start .. end [step n] [degrees|radians] [packed bits]
+     
+     Evaluates the expression for each x at translation time and declares NAME as a list
+     of the results, so that the program looks values up rather than computing them,
+     for example #table SINTAB := sin(x) for x = 0 .. 359 degrees.
+     
+     With packed, each result must be an integer that fits in the given number of bits,
+     and 64/bits of them are packed into each #...:64h integer, the first in the lowest
+     bits, as grob packs pixels. A list longer than the 10,000 elements the HP Prime
+     allows is split into a list of shorter lists.
+     */
+    class Table {
+    public:
+        static bool isTableDefinition(const std::string& str);
+        
+        // The LOCAL declaring the table, or an empty string if the definition is not valid.
+        static std::string processTableDefinition(const std::string& str);
+    };
+}
+
+#endif /* table_hpp */
@@ -28,6 +28,7 @@
 #include <vector>
 #include <cstdlib>
 #include <cstring>
+#include <thread>
 
 #if defined(_WIN32)
     #include <windows.h>
@@ -36,6 +37,9 @@
     #include <unistd.h>
     #include <spawn.h>
     #include <sys/wait.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <cerrno>
 #endif
 
 #if defined(__APPLE__)
@@ -48,7 +52,7 @@ extern char **environ;
 
 using namespace tool;
 
-static std::string executableDir()
+std::string tool::executableDir()
 {
 #ifdef DEBUG
     return "/usr/local/bin";
@@ -155,15 +159,19 @@ result_t tool::runTool(const std::string& command,
         return r;
     }
 
+    // Both pipes are read while the child runs so that neither can fill up and block it.
+    std::thread errReader([&r, errRead]() {
+        r.err = readPipe(errRead);
+    });
+    r.out = readPipe(outRead);
+    errReader.join();
+
     WaitForSingleObject(pi.hProcess, INFINITE);
 
     DWORD code;
     GetExitCodeProcess(pi.hProcess, &code);
     r.exitCode = static_cast<int>(code);
 
-    r.out = readPipe(outRead);
-    r.err = readPipe(errRead);
-
     CloseHandle(outRead);
     CloseHandle(errRead);
     CloseHandle(pi.hProcess);
@@ -174,16 +182,55 @@ result_t tool::runTool(const std::string& command,
 
 #else // POSIX
 
-static std::string readFd(int fd)
+/*
+ Creates a pipe that is not inherited by other children, which matters when tools are
+ run concurrently: a child holding on to another child's write end would keep that
+ pipe from reaching EOF.
+ */
+static void makePipe(int fds[2])
 {
-    std::string result;
-    char buffer[4096];
+#if defined(__linux__)
+    pipe2(fds, O_CLOEXEC);
+#else
+    pipe(fds);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+}
 
-    ssize_t n;
-    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
-        result.append(buffer, n);
+/*
+ Reads stdout and stderr of the child until both reach EOF, using poll so that
+ neither pipe can fill up and block the child while the other is being read.
+ */
+static void drain(int outFd, int errFd, std::string& out, std::string& err)
+{
+    char buffer[16384];
+    struct pollfd fds[2] = {
+        {outFd, POLLIN, 0},
+        {errFd, POLLIN, 0}
+    };
+    std::string* sinks[2] = {&out, &err};
+    int open = 2;
+
+    while (open > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < 2; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                sinks[i]->append(buffer, n);
+            } else if (n == 0 || errno != EINTR) {
+                // EOF, stop polling this pipe.
+                fds[i].fd = -1;
+                open--;
+            }
+        }
     }
-    return result;
 }
 
 
@@ -195,8 +242,8 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
     // Pipes for stdout and stderr
     int outPipe[2];
     int errPipe[2];
-    pipe(outPipe);
-    pipe(errPipe);
+    makePipe(outPipe);
+    makePipe(errPipe);
 
     posix_spawn_file_actions_t actions;
     posix_spawn_file_actions_init(&actions);
@@ -227,8 +274,7 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
     result_t result{};
 
     if (rc == 0) {
-        result.out = readFd(outPipe[0]);
-        result.err = readFd(errPipe[0]);
+        drain(outPipe[0], errPipe[0], result.out, result.err);
 
         int status;
         waitpid(pid, &status, 0);
@@ -249,4 +295,3 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
 }
 
 #endif
-
@@ -34,5 +34,8 @@ namespace tool {
         std::string err;
     };
     
+    // Directory holding the ppl+ executable, where add-ons are installed.
+    std::string executableDir();
+    
     result_t runTool(const std::string& command, const std::vector<std::string>& arguments);
 }
@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tree_shaker.hpp"
+#include "lexer.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+using pplplus::TreeShaker;
+using pplplus::Lexer;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+// A forward declaration, `name(params);`, outside of any function.
+typedef struct TDeclaration {
+    std::string name;
+    size_t first;
+    size_t last;
+} TDeclaration;
+
+// Index of the ')' matching the '(' at index open, or tokens.size().
+static size_t closingParenthesis(const std::vector<TToken>& tokens, size_t open) {
+    int depth = 0;
+    for (size_t i = open; i < tokens.size(); i++) {
+        if (Lexer::is(tokens[i], Type::Operator, "(")) depth++;
+        if (Lexer::is(tokens[i], Type::Operator, ")") && --depth == 0) return i;
+    }
+    return tokens.size();
+}
+
+// The last token of a function, including the ; after its END.
+static size_t functionEnd(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    if (function.end + 1 < tokens.size() && Lexer::is(tokens[function.end + 1], Type::Operator, ";")) return function.end + 1;
+    return std::min(function.end, tokens.size() - 1);
+}
+
+// VIEW "Title", Function() ahead of a function makes it an entry point in the Apps view.
+static bool isViewed(const std::vector<TToken>& tokens, const Lexer::TFunction& function) {
+    size_t i = function.start;
+    return i >= 3 && Lexer::is(tokens[i - 1], Type::Operator, ",") && tokens[i - 2].type == Type::String &&
+    Lexer::is(tokens[i - 3], Type::Identifier, "VIEW");
+}
+
+// The functions of an app that the HP Prime calls itself, such as START when the app starts.
+static bool isAppFunction(const std::string& name) {
+    static const std::unordered_set<std::string> names = {
+        "START", "RESET", "Symb", "SymbSetup", "Plot", "PlotSetup", "Num", "NumSetup", "Info"
+    };
+    return names.contains(name);
+}
+
+// Removes tokens first to last as Lexer::erase does, along with the blank lines that separated them from what follows.
+static Lexer::TEdit eraseWithBlankLines(const std::string& code, const std::vector<TToken>& tokens, size_t first, size_t last) {
+    Lexer::TEdit edit = Lexer::erase(code, tokens, first, last);
+    size_t end = edit.offset + edit.length;
+    if (edit.offset > 0 && code[edit.offset - 1] != '\n') return edit;
+    
+    for (size_t i = end; i < code.size(); i++) {
+        if (code[i] == '\n') end = i + 1;
+        else if (code[i] != ' ' && code[i] != '\t' && code[i] != '\r') break;
+    }
+    
+    // At the end of the code, the blank lines before go instead.
+    size_t start = edit.offset;
+    if (code.find_first_not_of(" \t\r\n", end) == std::string::npos) {
+        end = code.size();
+        while (start > 0 && std::string_view(" \t\r\n").find(code[start - 1]) != std::string_view::npos) start--;
+        if (start > 0) start++;
+    }
+    return {start, end - start, ""};
+}
+
+std::string TreeShaker::shake(const std::string& code) {
+    _removed.clear();
+    
+    std::vector<TToken> tokens = Lexer::tokenize(code);
+    std::vector<Lexer::TFunction> functions = Lexer::functions(tokens);
+    if (functions.empty()) return code;
+    
+    std::unordered_map<std::string, std::vector<size_t>> definitions;
+    for (size_t n = 0; n < functions.size(); n++) {
+        definitions[functions[n].name].push_back(n);
+    }
+    
+    std::unordered_set<std::string> reachable;
+    std::vector<std::string> pending;
+    
+    auto reference = [&](std::string_view name) {
+        auto it = definitions.find(std::string(name));
+        if (it == definitions.end() || reachable.contains(it->first)) return;
+        reachable.insert(it->first);
+        pending.push_back(it->first);
+    };
+    
+    auto scan = [&](size_t first, size_t last) {
+        for (size_t i = first; i <= last && i < tokens.size(); i++) {
+            const TToken& token = tokens[i];
+            if (token.type == Type::Identifier) {
+                reference(token.text);
+            } else if (token.type == Type::String || token.type == Type::Directive) {
+                for (std::string_view word : Lexer::words(token.text)) reference(word);
+            }
+        }
+    };
+    
+    for (const Lexer::TFunction& function : functions) {
+        if (function.exported || isViewed(tokens, function) || isAppFunction(function.name)) reference(function.name);
+    }
+    
+    // Code outside of functions, where a call to a known function is a forward declaration.
+    std::vector<TDeclaration> declarations;
+    size_t next = 0;
+    auto scanOutside = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            const TToken& token = tokens[i];
+            bool statementStart = i == first || Lexer::is(tokens[i - 1], Type::Operator, ";") || tokens[i - 1].type == Type::Directive;
+            
+            if (statementStart && definitions.contains(token.text) && i + 1 < last && Lexer::is(tokens[i + 1], Type::Operator, "(")) {
+                size_t close = closingParenthesis(tokens, i + 1);
+                if (close + 1 < last && Lexer::is(tokens[close + 1], Type::Operator, ";")) {
+                    declarations.push_back({token.text, i, close + 1});
+                    i = close + 1;
+                    continue;
+                }
+            }
+            scan(i, i);
+        }
+    };
+    
+    for (const Lexer::TFunction& function : functions) {
+        scanOutside(next, function.start);
+        next = functionEnd(tokens, function) + 1;
+    }
+    scanOutside(next, tokens.size());
+    
+    while (!pending.empty()) {
+        std::string name = pending.back();
+        pending.pop_back();
+        for (size_t n : definitions[name]) {
+            scan(functions[n].params, functions[n].end);
+        }
+    }
+    
+    std::vector<Lexer::TEdit> edits;
+    for (const Lexer::TFunction& function : functions) {
+        if (reachable.contains(function.name)) continue;
+        edits.push_back(eraseWithBlankLines(code, tokens, function.start, functionEnd(tokens, function)));
+        _removed.push_back(function.name);
+    }
+    for (const TDeclaration& declaration : declarations) {
+        if (reachable.contains(declaration.name)) continue;
+        edits.push_back(Lexer::erase(code, tokens, declaration.first, declaration.last));
+    }
+    
+    if (edits.empty()) return code;
+    return Lexer::apply(code, edits);
+}
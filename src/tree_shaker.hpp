@@ -0,0 +1,57 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef TREE_SHAKER_HPP
+#define TREE_SHAKER_HPP
+
+#include <string>
+#include <vector>
+
+namespace pplplus {
+    /*
+     Removes the functions a program never uses, typically helpers pulled in from a
+     library with {$I} or #include.
+     
+     EXPORT and KEY functions, functions named by a VIEW, the functions an app has the
+     calculator call, such as START and Plot, and anything referenced from code outside
+     of functions are kept, along with every function they reference in turn. A name
+     that appears inside a string or a #PYTHON or #CAS block also counts as a reference,
+     so functions called through EXPR are not lost. The forward declarations of removed
+     functions are removed with them, as are the blank lines left behind.
+     */
+    class TreeShaker {
+    public:
+        std::string shake(const std::string& code);
+        
+        // Functions removed by the last call to shake.
+        const std::vector<std::string>& removed(void) const {
+            return _removed;
+        }
+        
+    private:
+        std::vector<std::string> _removed;
+    };
+}
+
+#endif // TREE_SHAKER_HPP
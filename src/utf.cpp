@@ -24,97 +24,332 @@
 
 #include "utf.hpp"
 
-std::string utf::utf8(const std::wstring& wstr) {
-    std::string utf8;
-    uint16_t utf16 = 0;
+#include <bit>
+#include <vector>
+#include <cstring>
 
-    for (size_t i = 0; i < wstr.size(); i++) {
-        utf16 = static_cast<uint16_t>(wstr[i]);
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define UTF_SSE2
+#endif
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define UTF_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define UTF_NEON
+#endif
 
-        if (utf16 <= 0x007F) {
-            // 1-byte UTF-8: 0xxxxxxx
-            utf8 += static_cast<char>(utf16 & 0x7F);
-        } else if (utf16 <= 0x07FF) {
-            // 2-byte UTF-8: 110xxxxx 10xxxxxx
-            utf8 += static_cast<char>(0b11000000 | ((utf16 >> 6) & 0b00011111));
-            utf8 += static_cast<char>(0b10000000 | (utf16 & 0b00111111));
+// Size of the blocks of UTF-16 code units written out in one go.
+#define BLOCK_SIZE 16384
+
+/*
+ MARK: - Transcoding
+ 
+ UTF-8 is decoded into, and encoded from, code units of type C. C is either char16_t,
+ or wchar_t which is 16-bit on Windows and 32-bit elsewhere. Either way the units hold
+ UTF-16, so code points above U+FFFF are stored as surrogate pairs.
+ 
+ Most PPL is ASCII, so runs of ASCII are converted a vector at a time, using AVX2
+ or SSE2 on x86_64 and NEON on arm64. Everything else falls back to the scalar loop
+ one code point at a time.
+ */
+
+template<typename C>
+static size_t widenASCII(const uint8_t* src, size_t size, C* dst) {
+    size_t i = 0;
+    
+#if defined(UTF_AVX2)
+    if constexpr (sizeof(C) == 2) {
+        for (; i + 32 <= size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            if (_mm256_movemask_epi8(v)) break;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        }
+    }
+#endif
+    
+#if defined(UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v)) break;
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        if constexpr (sizeof(C) == 2) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), hi);
         } else {
-            // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
-            utf8 += static_cast<char>(0b11100000 | ((utf16 >> 12) & 0b00001111));
-            utf8 += static_cast<char>(0b10000000 | ((utf16 >> 6) & 0b00111111));
-            utf8 += static_cast<char>(0b10000000 | (utf16 & 0b00111111));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
         }
     }
-
-    return utf8;
+#elif defined(UTF_NEON)
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) break;
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        if constexpr (sizeof(C) == 2) {
+            vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), lo);
+            vst1q_u16(reinterpret_cast<uint16_t*>(dst + i + 8), hi);
+        } else {
+            vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), vmovl_u16(vget_low_u16(lo)));
+            vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 4), vmovl_u16(vget_high_u16(lo)));
+            vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 8), vmovl_u16(vget_low_u16(hi)));
+            vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 12), vmovl_u16(vget_high_u16(hi)));
+        }
+    }
+#endif
+    
+    for (; i < size && src[i] < 0x80; i++) {
+        dst[i] = static_cast<C>(src[i]);
+    }
+    
+    return i;
 }
 
-
-std::wstring utf::utf16(const std::string& str) {
-    std::wstring utf16;
+template<typename C>
+static size_t narrowASCII(const C* src, size_t size, uint8_t* dst) {
     size_t i = 0;
+    
+#if defined(UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    if constexpr (sizeof(C) == 2) {
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+        for (; i + 16 <= size; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+            __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+        }
+    } else {
+        const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+        for (; i + 16 <= size; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+            __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+    }
+#elif defined(UTF_NEON)
+    if constexpr (sizeof(C) == 2) {
+        for (; i + 16 <= size; i += 16) {
+            uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+            uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i + 8));
+            if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        }
+    } else {
+        for (; i + 16 <= size; i += 16) {
+            uint32x4_t a = vld1q_u32(reinterpret_cast<const uint32_t*>(src + i));
+            uint32x4_t b = vld1q_u32(reinterpret_cast<const uint32_t*>(src + i + 4));
+            uint32x4_t c = vld1q_u32(reinterpret_cast<const uint32_t*>(src + i + 8));
+            uint32x4_t d = vld1q_u32(reinterpret_cast<const uint32_t*>(src + i + 12));
+            if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) break;
+            uint16x8_t lo = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+            uint16x8_t hi = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        }
+    }
+#endif
+    
+    for (; i < size && static_cast<uint32_t>(src[i]) < 0x80; i++) {
+        dst[i] = static_cast<uint8_t>(src[i]);
+    }
+    
+    return i;
+}
 
-    while (i < str.size()) {
-        uint8_t byte1 = static_cast<uint8_t>(str[i]);
-
-        if ((byte1 & 0b10000000) == 0) {
-            // 1-byte UTF-8: 0xxxxxxx
-            utf16 += static_cast<wchar_t>(byte1);
-            i += 1;
-        } else if ((byte1 & 0b11100000) == 0b11000000) {
+/*
+ Decodes UTF-8 into UTF-16 code units, dst must have room for size units. Invalid bytes
+ are skipped and decoding stops at a truncated sequence. The number of bytes consumed
+ is returned through used, so a caller decoding in blocks can carry over a truncated
+ sequence into the next block.
+ */
+template<typename C>
+static size_t decodeUTF8(const uint8_t* src, size_t size, C* dst, size_t* used = nullptr) {
+    size_t i = 0, n = 0;
+    
+    while (i < size) {
+        if (src[i] < 0x80) {
+            size_t run = widenASCII(src + i, size - i, dst + n);
+            i += run;
+            n += run;
+            continue;
+        }
+        
+        uint8_t byte1 = src[i];
+        uint32_t code;
+        size_t length;
+        
+        if ((byte1 & 0b11100000) == 0b11000000) {
             // 2-byte UTF-8: 110xxxxx 10xxxxxx
-            if (i + 1 >= str.size()) break;
-            uint8_t byte2 = static_cast<uint8_t>(str[i + 1]);
-
-            uint16_t ch = ((byte1 & 0b00011111) << 6) |
-                          (byte2 & 0b00111111);
-            utf16 += static_cast<wchar_t>(ch);
-            i += 2;
+            code = byte1 & 0b00011111;
+            length = 2;
         } else if ((byte1 & 0b11110000) == 0b11100000) {
             // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
-            if (i + 2 >= str.size()) break;
-            uint8_t byte2 = static_cast<uint8_t>(str[i + 1]);
-            uint8_t byte3 = static_cast<uint8_t>(str[i + 2]);
-
-            uint16_t ch = ((byte1 & 0b00001111) << 12) |
-                          ((byte2 & 0b00111111) << 6) |
-                          (byte3 & 0b00111111);
-            utf16 += static_cast<wchar_t>(ch);
-            i += 3;
+            code = byte1 & 0b00001111;
+            length = 3;
+        } else if ((byte1 & 0b11111000) == 0b11110000) {
+            // 4-byte UTF-8: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+            code = byte1 & 0b00000111;
+            length = 4;
         } else {
             // Invalid or unsupported UTF-8 sequence
             i += 1; // Skip it
+            continue;
+        }
+        
+        if (i + length > size) break;
+        
+        size_t k = 1;
+        for (; k < length && (src[i + k] & 0b11000000) == 0b10000000; k++) {
+            code = (code << 6) | (src[i + k] & 0b00111111);
+        }
+        if (k < length) {
+            i += 1; // Skip the lead byte of a broken sequence
+            continue;
+        }
+        
+        if (code > 0xFFFF) {
+            // Surrogate pair
+            code -= 0x10000;
+            dst[n++] = static_cast<C>(0xD800 + (code >> 10));
+            dst[n++] = static_cast<C>(0xDC00 + (code & 0x3FF));
+        } else {
+            dst[n++] = static_cast<C>(code);
         }
+        i += length;
     }
-
-    return utf16;
+    
+    if (used) *used = i;
+    return n;
 }
 
+/*
+ Encodes UTF-16 code units as UTF-8, dst must have room for size * 3 bytes. Surrogate
+ pairs are combined into a single 4-byte sequence, a 32-bit wchar_t holding a code point
+ above U+FFFF is encoded directly.
+ */
+template<typename C>
+static size_t encodeUTF8(const C* src, size_t size, uint8_t* dst) {
+    size_t i = 0, n = 0;
+    
+    while (i < size) {
+        uint32_t code = static_cast<uint32_t>(src[i]);
+        
+        if (code < 0x80) {
+            size_t run = narrowASCII(src + i, size - i, dst + n);
+            i += run;
+            n += run;
+            continue;
+        }
+        
+        i++;
+        if (code >= 0xD800 && code <= 0xDBFF && i < size) {
+            uint32_t low = static_cast<uint32_t>(src[i]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        
+        if (code <= 0x07FF) {
+            // 2-byte UTF-8: 110xxxxx 10xxxxxx
+            dst[n++] = static_cast<uint8_t>(0b11000000 | (code >> 6));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | (code & 0b00111111));
+        } else if (code <= 0xFFFF) {
+            // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
+            dst[n++] = static_cast<uint8_t>(0b11100000 | (code >> 12));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | ((code >> 6) & 0b00111111));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | (code & 0b00111111));
+        } else {
+            // 4-byte UTF-8: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+            dst[n++] = static_cast<uint8_t>(0b11110000 | ((code >> 18) & 0b00000111));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | ((code >> 12) & 0b00111111));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | ((code >> 6) & 0b00111111));
+            dst[n++] = static_cast<uint8_t>(0b10000000 | (code & 0b00111111));
+        }
+    }
+    
+    return n;
+}
 
-static uint16_t convertUTF8ToUTF16(const char* str) {
-    uint8_t *utf8 = (uint8_t *)str;
-    uint16_t utf16 = *utf8;
+/*
+ Writes UTF-16 code units to the stream in the requested byte order, dropping any
+ carriage returns. The units are written in bulk through the block buffer.
+ */
+template<typename C>
+static size_t writeUnits(std::ofstream& os, const C* src, size_t size, utf::BOM bom, std::vector<char16_t>& block) {
+    // Only big-endian output, or a big-endian host, needs the bytes swapping.
+    bool swap = (bom == utf::BOMbe) == (std::endian::native == std::endian::little);
+    size_t written = 0;
     
-    if ((utf8[0] & 0b11110000) == 0b11100000) {
-        utf16 = utf8[0] & 0b11111;
-        utf16 <<= 6;
-        utf16 |= utf8[1] & 0b111111;
-        utf16 <<= 6;
-        utf16 |= utf8[2] & 0b111111;
-        return utf16;
+    block.resize(BLOCK_SIZE);
+    while (size) {
+        size_t count = std::min(size, static_cast<size_t>(BLOCK_SIZE));
+        size_t n = 0;
+        
+        for (size_t i = 0; i < count; i++) {
+            char16_t unit = static_cast<char16_t>(src[i]);
+            if (unit == u'\r') continue;
+            block[n++] = swap ? static_cast<char16_t>(unit >> 8 | unit << 8) : unit;
+        }
+        
+        os.write(reinterpret_cast<const char*>(block.data()), n * sizeof(char16_t));
+        written += n * sizeof(char16_t);
+        src += count;
+        size -= count;
     }
     
-    // 110xxxxx 10xxxxxx
-    if ((utf8[0] & 0b11100000) == 0b11000000) {
-        utf16 = utf8[0] & 0b11111;
-        utf16 <<= 6;
-        utf16 |= utf8[1] & 0b111111;
-        return utf16;
+    return written;
+}
+
+static void writeBOM(std::ofstream& os, utf::BOM bom) {
+    if (bom == utf::BOMle) {
+        os.put(0xFF);
+        os.put(0xFE);
     }
     
+    if (bom == utf::BOMbe) {
+        os.put(0xFE);
+        os.put(0xFF);
+    }
+}
+
+// MARK: -
+
+std::string utf::utf8(const std::wstring& wstr) {
+    std::string utf8;
+    
+    utf8.resize(wstr.size() * 3);
+    size_t n = encodeUTF8(wstr.data(), wstr.size(), reinterpret_cast<uint8_t*>(utf8.data()));
+    utf8.resize(n);
+    
+    return utf8;
+}
+
+
+std::wstring utf::utf16(const std::string& str) {
+    std::wstring utf16;
+    
+    utf16.resize(str.size());
+    size_t n = decodeUTF8(reinterpret_cast<const uint8_t*>(str.data()), str.size(), utf16.data());
+    utf16.resize(n);
+    
     return utf16;
 }
 
+
 std::string utf::read(std::ifstream& is) {
     if (!is) throw std::runtime_error("Cannot open file");
 
@@ -124,43 +359,48 @@ std::string utf::read(std::ifstream& is) {
     return str;
 }
 
-std::wstring utf::read(std::ifstream& is, BOM bom) {
-    std::wstring wstr;
-    uint16_t byte_order_mark;
+/*
+ Reads the remainder of a UTF-16 stream in one go, checking the byte order mark against
+ the expected BOM. Units are returned in native byte order, up to the first NUL.
+ */
+static std::u16string readUnits(std::ifstream& is, utf::BOM bom) {
+    std::u16string units;
     
-    is.read(reinterpret_cast<char*>(&byte_order_mark), sizeof(byte_order_mark));
+    if (!is) return units;
     
-#ifdef __BIG_ENDIAN__
-    if (bom == BOMle && byte_order_mark != 0xFFFE) {
-        utf16 = utf16 >> 8 | utf16 << 8;
-    }
-    if (bom == BOMbe && byte_order_mark != 0xFEFF) {
-        utf16 = utf16 >> 8 | utf16 << 8;
-    }
-#else
-    if (bom == BOMle && byte_order_mark != 0xFEFF) {
-        return wstr;
-    }
-    if (bom == BOMbe && byte_order_mark != 0xFFFE) {
-        return wstr;
-    }
-#endif
+    std::streampos start = is.tellg();
+    is.seekg(0, std::ios::end);
+    std::streamoff size = is.tellg() - start;
+    is.seekg(start);
+    if (size < 2) return units;
     
-    while (true) {
-        char16_t ch;
-        // Read 2 bytes (UTF-16)
-        is.read(reinterpret_cast<char*>(&ch), sizeof(ch));
-        
-        if (!is || ch == 0x0000) {
-            break; // EOF or null terminator
+    units.resize(static_cast<size_t>(size) / sizeof(char16_t));
+    is.read(reinterpret_cast<char*>(units.data()), units.size() * sizeof(char16_t));
+    units.resize(static_cast<size_t>(is.gcount()) / sizeof(char16_t));
+    
+    bool swap = (bom == utf::BOMbe) == (std::endian::native == std::endian::little);
+    if (swap) {
+        for (char16_t& unit : units) {
+            unit = static_cast<char16_t>(unit >> 8 | unit << 8);
         }
-        
-        wstr += static_cast<wchar_t>(ch);
-        is.peek();
-        if (is.eof()) break;
     }
     
-    return wstr;
+    size_t offset = 0;
+    if (bom != utf::BOMnone) {
+        if (units.empty() || units.front() != 0xFEFF) return {};
+        offset = 1;
+    }
+    
+    size_t end = units.find(u'\0', offset);
+    if (end != std::u16string::npos) units.resize(end);
+    units.erase(0, offset);
+    
+    return units;
+}
+
+std::wstring utf::read(std::ifstream& is, BOM bom) {
+    std::u16string units = readUnits(is, bom);
+    return std::wstring(units.begin(), units.end());
 }
 
 std::string utf::load(const std::filesystem::path& path) {
@@ -191,6 +431,29 @@ std::wstring utf::load(const std::filesystem::path& path, BOM bom) {
 }
 
 
+std::string utf::loadText(const std::filesystem::path& path) {
+    std::string str;
+    std::ifstream is;
+    
+    is.open(path, std::ios::in | std::ios::binary);
+    if(!is.is_open()) return str;
+    
+    BOM bom = utf::bom(is);
+    is.clear();
+    is.seekg(0);
+    if (bom == BOMnone) {
+        str = read(is);
+    } else {
+        std::u16string units = readUnits(is, bom);
+        str.resize(units.size() * 3);
+        str.resize(encodeUTF8(units.data(), units.size(), reinterpret_cast<uint8_t*>(str.data())));
+    }
+    
+    is.close();
+    return str;
+}
+
+
 size_t utf::write(std::ofstream& os, const std::string& str) {
     if (str.empty()) return 0;
 
@@ -202,47 +465,41 @@ size_t utf::write(std::ofstream& os, const std::string& str) {
 size_t utf::write(std::ofstream& os, const std::wstring& wstr, BOM bom) {
     if (wstr.empty()) return 0;
     
-    if (bom == BOMle) {
-        os.put(0xFF);
-        os.put(0xFE);
-    }
+    std::vector<char16_t> block;
     
-    if (bom == BOMbe) {
-        os.put(0xFE);
-        os.put(0xFF);
-    }
+    writeBOM(os, bom);
+    return writeUnits(os, wstr.data(), wstr.size(), bom, block);
+}
+
+
+size_t utf::write(std::ofstream& os, std::string_view str, BOM bom) {
+    if (str.empty()) return 0;
+    
+    std::vector<char16_t> units(std::min(str.size(), static_cast<size_t>(BLOCK_SIZE)));
+    std::vector<char16_t> block;
+    size_t written = 0;
     
-    std::string str = utf8(wstr);
+    writeBOM(os, bom);
     
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(str.data());
+    size_t size = str.size();
     
-    size_t size = 0;
-    for ( int n = 0; n < str.length(); n++, size += 2) {
-        uint8_t *ascii = (uint8_t *)&str.at(n);
-        if (str.at(n) == '\r') continue;
+    while (size) {
+        size_t used;
+        size_t n = decodeUTF8(src, std::min(size, static_cast<size_t>(BLOCK_SIZE)), units.data(), &used);
         
-        // Output as UTF-16LE
-        if (*ascii >= 0x80) {
-            uint16_t utf16 = convertUTF8ToUTF16(&str.at(n));
-            
-#ifndef __LITTLE_ENDIAN__
-            if (bom == BOMle) {
-                utf16 = utf16 >> 8 | utf16 << 8;
-            }
-#else
-            if (bom == BOMbe) {
-                utf16 = utf16 >> 8 | utf16 << 8;
-            }
-#endif
-            os.write((const char *)&utf16, 2);
-            if ((*ascii & 0b11100000) == 0b11000000) n++;
-            if ((*ascii & 0b11110000) == 0b11100000) n+=2;
-            if ((*ascii & 0b11111000) == 0b11110000) n+=3;
-        } else {
-            os.put(str.at(n));
-            os.put('\0');
+        // A sequence cut short by the end of the block is decoded with the next block.
+        if (used == 0) {
+            if (size <= BLOCK_SIZE) break;
+            used = 1;
         }
+        
+        written += writeUnits(os, units.data(), n, bom, block);
+        src += used;
+        size -= used;
     }
-    return size;
+    
+    return written;
 }
 
 
@@ -270,6 +527,18 @@ bool utf::save(const std::filesystem::path& path, const std::wstring& wstr, BOM
     return true;
 }
 
+bool utf::save(const std::filesystem::path& path, std::string_view str, BOM bom) {
+    std::ofstream os;
+    
+    os.open(path, std::ios::out | std::ios::binary);
+    if(!os.is_open()) return false;
+    
+    write(os, str, bom);
+    
+    os.close();
+    return true;
+}
+
 utf::BOM utf::bom(std::ifstream& is) {
     if(!is.is_open()) return BOMnone;
     
@@ -26,6 +26,7 @@
 #define utf_hpp
 
 #include <sstream>
+#include <string_view>
 #include <fstream>
 #include <cstdlib>
 #include <filesystem>
@@ -43,10 +44,13 @@ namespace utf {
     std::wstring read(std::ifstream& is, BOM bom);
     std::string load(const std::filesystem::path& path);
     std::wstring load(const std::filesystem::path& path, BOM bom);
+    std::string loadText(const std::filesystem::path& path);
     size_t write(std::ofstream& os, const std::string& str);
     size_t write(std::ofstream& os, const std::wstring& wstr, BOM bom = BOMle);
+    size_t write(std::ofstream& os, std::string_view str, BOM bom);
     bool save(const std::filesystem::path& path, const std::string& str);
     bool save(const std::filesystem::path& path, const std::wstring& wstr, BOM bom = BOMle);
+    bool save(const std::filesystem::path& path, std::string_view str, BOM bom);
     BOM bom(std::ifstream& is);
     BOM bom(const std::filesystem::path& path);
 };
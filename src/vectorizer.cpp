@@ -0,0 +1,400 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vectorizer.hpp"
+#include "lexer.hpp"
+#include "expression.hpp"
+
+#include <map>
+#include <numeric>
+#include <algorithm>
+#include <unordered_set>
+
+using pplplus::Vectorizer;
+using pplplus::Lexer;
+using pplplus::Expression;
+using pplplus::Edits;
+
+typedef Lexer::TToken TToken;
+typedef Lexer::Type Type;
+
+#define MAX_ROUNDS 4
+
+// FOR var FROM start TO end DO body END, or FOR var := start TO end DO body END
+typedef struct TFor {
+    size_t first;           // FOR
+    size_t last;            // END, or the ; after it.
+    size_t var;
+    size_t from;
+    size_t to;
+    size_t body;            // First token after DO.
+    size_t end;             // END
+} TFor;
+
+// Built-in names are matched in any case, as the translator leaves size(L) as written.
+static bool isBuiltin(const TToken& token, std::string_view name) {
+    return token.type == Type::Identifier && token.text.size() == name.size() &&
+    std::equal(name.begin(), name.end(), token.text.begin(), [](char a, char b) {
+        return a == std::toupper(static_cast<unsigned char>(b));
+    });
+}
+
+// name(var), as in L(i)
+static bool isElement(const std::vector<TToken>& tokens, size_t i, size_t last, const std::string& name, const std::string& var) {
+    return i + 3 <= last && Lexer::is(tokens[i], Type::Identifier, name) && Lexer::isOperator(tokens[i + 1], "(") &&
+    Lexer::is(tokens[i + 2], Type::Identifier, var) && Lexer::isOperator(tokens[i + 3], ")");
+}
+
+// Whether any token from first to last is the name, other than after a '.'.
+static bool uses(const std::vector<TToken>& tokens, size_t first, size_t last, const std::string& name) {
+    for (size_t i = first; i <= last; i++) {
+        if (Lexer::is(tokens[i], Type::Identifier, name) && (i == 0 || !Lexer::isOperator(tokens[i - 1], "."))) return true;
+    }
+    return false;
+}
+
+// An operator outside any brackets that is one of ops.
+static bool hasOperator(const std::vector<TToken>& tokens, size_t first, size_t last, std::initializer_list<std::string_view> ops) {
+    int depth = 0;
+    for (size_t i = first; i <= last; i++) {
+        if (Lexer::isOpening(tokens[i])) depth++;
+        if (Lexer::isClosing(tokens[i])) depth--;
+        if (depth) continue;
+        for (std::string_view op : ops) {
+            if (tokens[i].text == op && tokens[i].type != Type::String && tokens[i].type != Type::Number) return true;
+        }
+    }
+    return false;
+}
+
+static bool isNumber(const std::vector<TToken>& tokens, size_t first, size_t last, double& value) {
+    return first <= last && Expression::evaluate(tokens, first, last, value);
+}
+
+static bool parse(const std::vector<TToken>& tokens, size_t i, size_t end, TFor& loop, std::string& reason) {
+    loop.first = i;
+    loop.end = Lexer::blockEnd(tokens, i);
+    if (loop.end >= end) {
+        reason = "the loop has no END";
+        return false;
+    }
+    loop.last = loop.end + 1 < tokens.size() && Lexer::isOperator(tokens[loop.end + 1], ";") ? loop.end + 1 : loop.end;
+    
+    loop.var = i + 1;
+    if (loop.var + 1 >= loop.end || tokens[loop.var].type != Type::Identifier ||
+        !(Lexer::isIdentifier(tokens[loop.var + 1], "FROM") || Lexer::isOperator(tokens[loop.var + 1], ":="))) {
+        reason = "the loop is not FOR var FROM ... TO ... DO";
+        return false;
+    }
+    loop.from = loop.var + 2;
+    
+    loop.to = loop.from;
+    while (loop.to < loop.end && !Lexer::isIdentifier(tokens[loop.to], "TO") && !Lexer::isIdentifier(tokens[loop.to], "DOWNTO")) loop.to++;
+    size_t doing = loop.to;
+    while (doing < loop.end && !Lexer::isIdentifier(tokens[doing], "DO")) doing++;
+    if (doing >= loop.end || Lexer::isIdentifier(tokens[loop.to], "DOWNTO") || uses(tokens, loop.to, doing, "STEP")) {
+        reason = "the loop counts down or has a STEP";
+        return false;
+    }
+    loop.body = doing + 1;
+    return true;
+}
+
+/*
+ True if the expression only reads variables, elements of lists and built-ins with no
+ side effects, so it can be evaluated by MAKELIST.
+ */
+static bool isPure(const std::vector<TToken>& tokens, size_t first, size_t last, const std::unordered_set<std::string>& functions) {
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::Directive) return false;
+        if (token.type == Type::Operator && (token.text == ":=" || token.text == "▶" || token.text == ".")) return false;
+        if (size_t name = functions.contains(token.text) ? 0 : Lexer::pureCall(tokens, i, true)) {
+            i += name - 1;
+            continue;
+        }
+        if (token.type != Type::Identifier || Lexer::isKeyword(token.text)) continue;
+        
+        // A call, unless it is a lookup of the form L(i).
+        if (i + 1 <= last && Lexer::isOperator(tokens[i + 1], "(")) {
+            size_t close = Lexer::closing(tokens, i + 1, last + 1);
+            if (close != i + 3 || tokens[i + 2].type != Type::Identifier) return false;
+        }
+    }
+    return true;
+}
+
+// The loop variable keeps the value the loop left it with, so it must not be read after the loop.
+static bool isVariableDead(const std::vector<TToken>& tokens, const TFor& loop, size_t end) {
+    const std::string& var = tokens[loop.var].text;
+    for (size_t i = loop.last + 1; i < end; i++) {
+        const TToken& token = tokens[i];
+        if (token.type == Type::String || token.type == Type::Directive) {
+            for (std::string_view word : Lexer::words(token.text)) {
+                if (word == var) return false;
+            }
+            continue;
+        }
+        if (!Lexer::is(token, Type::Identifier, var) || Lexer::isOperator(tokens[i - 1], ".")) continue;
+        if (Lexer::isIdentifier(tokens[i - 1], "FOR")) return true;
+        return Lexer::isStatementStart(tokens, i) && i + 1 < end && Lexer::isOperator(tokens[i + 1], ":=");
+    }
+    return true;
+}
+
+// The code from token first to last, with the tokens at each key up to the first of the value replaced by the second.
+static std::string substitute(std::string_view code, const std::vector<TToken>& tokens, size_t first, size_t last,
+                              const std::map<size_t, std::pair<size_t, std::string>>& replacements) {
+    std::string text;
+    size_t start = tokens[first].offset;
+    for (const auto& [from, replacement] : replacements) {
+        text += code.substr(start, tokens[from].offset - start);
+        text += replacement.second;
+        const TToken& token = tokens[replacement.first];
+        start = token.offset + token.text.size();
+    }
+    text += code.substr(start, tokens[last].offset + tokens[last].text.size() - start);
+    return text;
+}
+
+// MARK: - Loops
+
+static bool vectorize(std::string_view code, const std::vector<TToken>& tokens, const TFor& loop, size_t function,
+                      const std::unordered_set<std::string>& functions, std::string& text, std::string& reason) {
+    const std::string& var = tokens[loop.var].text;
+    
+    size_t last = Lexer::statementEnd(tokens, loop.body);
+    if (loop.body >= loop.end || (last != loop.end - 1 && last != loop.end)) {
+        reason = "the body is not a single statement";
+        return false;
+    }
+    if (Lexer::isOperator(tokens[last], ";") || last == loop.end) last--;
+    
+    // target := expression
+    size_t assign = loop.body;
+    while (assign <= last && !Lexer::isOperator(tokens[assign], ":=")) assign++;
+    if (assign > last || assign == loop.body || assign == last) {
+        reason = "the body is not an assignment";
+        return false;
+    }
+    size_t first = assign + 1;
+    
+    // L(i) := L(i + 1) reads an element that is written before or after it, depending on when.
+    if (assign == loop.body + 4 && isElement(tokens, loop.body, assign - 1, tokens[loop.body].text, var)) {
+        const std::string& list = tokens[loop.body].text;
+        for (size_t i = first; i <= last; i++) {
+            if (isElement(tokens, i, last, list, var)) {
+                i += 3;
+                continue;
+            }
+            if (Lexer::is(tokens[i], Type::Identifier, list) && i + 1 <= last && Lexer::isOpening(tokens[i + 1]) &&
+                !Lexer::isOperator(tokens[i - 1], ".")) {
+                reason = "the body reads an element the loop writes";
+                return false;
+            }
+        }
+    }
+    
+    if (!isPure(tokens, first, last, functions)) {
+        reason = "the body calls a function that may have side effects";
+        return false;
+    }
+    
+    double from, to;
+    bool counted = isNumber(tokens, loop.from, loop.to - 1, from) && isNumber(tokens, loop.to + 1, loop.body - 2, to);
+    std::string range = ", " + var + ", " + std::string(Lexer::text(code, tokens, loop.from, loop.to - 1)) + ", " +
+    std::string(Lexer::text(code, tokens, loop.to + 1, loop.body - 2)) + ")";
+    
+    // s := s + expression, s := expression + s and the same with *
+    if (assign == loop.body + 1) {
+        const std::string& sum = tokens[loop.body].text;
+        size_t begin = first, end = last;
+        std::string op;
+        if (Lexer::is(tokens[first], Type::Identifier, sum) && first + 1 < last && (Lexer::isOperator(tokens[first + 1], "+") || Lexer::isOperator(tokens[first + 1], "*"))) {
+            op = tokens[first + 1].text;
+            begin = first + 2;
+        } else if (Lexer::is(tokens[last], Type::Identifier, sum) && last - 1 > first && (Lexer::isOperator(tokens[last - 1], "+") || Lexer::isOperator(tokens[last - 1], "*"))) {
+            op = tokens[last - 1].text;
+            end = last - 2;
+        } else {
+            reason = "the body neither fills a list nor adds up or multiplies a value";
+            return false;
+        }
+        
+        if (uses(tokens, begin, end, sum)) {
+            reason = "the value is used other than to add to or multiply it";
+            return false;
+        }
+        if (hasOperator(tokens, begin, end, {"==", "=", "<", ">", "<=", ">=", "<>", "≤", "≥", "≠", "AND", "OR", "XOR", "NOT"}) ||
+            (op == "*" && hasOperator(tokens, begin + 1, end, {"+", "-"}))) {
+            reason = "the expression would group differently";
+            return false;
+        }
+        if (!counted || from > to) {
+            reason = "the bounds are not numbers, so the loop may not run";
+            return false;
+        }
+        
+        text = sum + " := " + sum + " " + op + " " + (op == "+" ? "ΣLIST" : "ΠLIST") + "(MAKELIST(" +
+        std::string(Lexer::text(code, tokens, begin, end)) + range + ")";
+        return true;
+    }
+    
+    // L(i) := expression
+    if (!isElement(tokens, loop.body, assign - 1, tokens[loop.body].text, var) || assign != loop.body + 4) {
+        reason = "the body assigns to something other than an element L(" + var + ")";
+        return false;
+    }
+    const std::string& list = tokens[loop.body].text;
+    
+    if (!uses(tokens, first, last, list)) {
+        // Filling a list emptied just before the loop.
+        size_t previous = loop.first;
+        bool emptied = previous >= function + 6 && Lexer::isOperator(tokens[previous - 1], ";") && Lexer::isOperator(tokens[previous - 2], "}") &&
+        Lexer::isOperator(tokens[previous - 3], "{") && Lexer::isOperator(tokens[previous - 4], ":=") &&
+        Lexer::is(tokens[previous - 5], Type::Identifier, list) && Lexer::isStatementStart(tokens, previous - 5);
+        if (!emptied) {
+            reason = "the list is not emptied before the loop, so it may keep elements the loop does not set";
+            return false;
+        }
+        if (!counted || from != 1 || to < 1) {
+            reason = "the bounds are not numbers starting from 1";
+            return false;
+        }
+        text = list + " := MAKELIST(" + std::string(Lexer::text(code, tokens, first, last)) + range;
+        return true;
+    }
+    
+    // L(i) := L(i)*2 + k over the whole list.
+    bool whole = isNumber(tokens, loop.from, loop.to - 1, from) && from == 1 && loop.to + 5 == loop.body - 1 && isBuiltin(tokens[loop.to + 1], "SIZE") && Lexer::isOperator(tokens[loop.to + 2], "(") &&
+    Lexer::is(tokens[loop.to + 3], Type::Identifier, list) && Lexer::isOperator(tokens[loop.to + 4], ")");
+    if (!whole) {
+        reason = "the loop does not run over the whole list from 1 to SIZE(" + list + ")";
+        return false;
+    }
+    
+    std::map<size_t, std::pair<size_t, std::string>> replacements;
+    for (size_t i = first; i <= last; i++) {
+        const TToken& token = tokens[i];
+        if (isElement(tokens, i, last, list, var)) {
+            replacements[i] = {i + 3, list};
+            i += 3;
+            continue;
+        }
+        bool scalar = token.type == Type::Number || (token.type == Type::Operator && (token.text == "+" || token.text == "-" ||
+            token.text == "*" || token.text == "/" || token.text == "(" || token.text == ")")) ||
+        (token.type == Type::Identifier && !Lexer::isKeyword(token.text) && token.text != var && token.text != list &&
+         (i + 1 > last || !Lexer::isOperator(tokens[i + 1], "(")));
+        if (!scalar) {
+            reason = "the new value of each element depends on more than " + list + "(" + var + ") and values that do not change";
+            return false;
+        }
+    }
+    
+    text = list + " := " + substitute(code, tokens, first, last, replacements);
+    return true;
+}
+
+/*
+ The line each line of the code will have come from once the edits are applied, given
+ where each line of the code came from, so that loops are reported where they were.
+ */
+static std::vector<long> originalLines(std::string_view code, std::vector<Lexer::TEdit> edits, const std::vector<long>& lines) {
+    std::sort(edits.begin(), edits.end(), [](const Lexer::TEdit& a, const Lexer::TEdit& b) { return a.offset < b.offset; });
+    
+    std::vector<long> result = {lines[0]};
+    size_t line = 0, pos = 0;
+    auto copy = [&](size_t end) {
+        for (; pos < end; pos++) {
+            if (code[pos] == '\n') result.push_back(lines[++line]);
+        }
+    };
+    
+    for (const Lexer::TEdit& edit : edits) {
+        copy(edit.offset);
+        for (char c : edit.text) {
+            if (c == '\n') result.push_back(lines[line]);
+        }
+        for (; pos < edit.offset + edit.length; pos++) {
+            if (code[pos] == '\n') line++;
+        }
+    }
+    copy(code.size());
+    return result;
+}
+
+// MARK: - Public Methods
+
+std::string Vectorizer::vectorize(const std::string& code) {
+    _vectorized = 0;
+    std::string result = code;
+    
+    std::vector<long> lines(std::count(code.begin(), code.end(), '\n') + 1);
+    std::iota(lines.begin(), lines.end(), 1);
+    
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        std::vector<TToken> tokens = Lexer::tokenize(result);
+        Edits edits;
+        std::vector<Lexer::TEdit> applied;
+        _skipped.clear();
+        
+        // Functions of the program, which are not built-ins whatever their case.
+        std::vector<Lexer::TFunction> functions = Lexer::functions(tokens);
+        std::unordered_set<std::string> names;
+        for (const Lexer::TFunction& function : functions) names.insert(function.name);
+        
+        for (const Lexer::TFunction& function : functions) {
+            if (function.end >= tokens.size()) continue;
+            
+            for (size_t i = function.begin + 1; i < function.end; i++) {
+                if (!Lexer::isIdentifier(tokens[i], "FOR") || !Lexer::isStatementStart(tokens, i)) continue;
+                
+                TFor loop;
+                std::string text, reason;
+                if (parse(tokens, i, function.end, loop, reason) && ::vectorize(result, tokens, loop, function.begin, names, text, reason)) {
+                    if (!isVariableDead(tokens, loop, function.end)) {
+                        reason = "the loop variable " + tokens[loop.var].text + " is read after the loop";
+                    } else {
+                        if (Lexer::isOperator(tokens[loop.last], ";")) text += ";";
+                        size_t start = tokens[loop.first].offset;
+                        Lexer::TEdit edit = {start, tokens[loop.last].offset + tokens[loop.last].text.size() - start, text};
+                        if (edits.add(edit)) {
+                            applied.push_back(edit);
+                            _vectorized++;
+                            i = loop.last;
+                            continue;
+                        }
+                    }
+                }
+                if (!reason.empty()) _skipped.push_back({function.name, lines[tokens[i].line - 1], reason});
+            }
+        }
+        
+        if (edits.empty()) break;
+        lines = originalLines(result, applied, lines);
+        result = edits.apply(result);
+    }
+    
+    return result;
+}
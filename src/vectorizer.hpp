@@ -0,0 +1,71 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Created: 2026-10-18
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef VECTORIZER_HPP
+#define VECTORIZER_HPP
+
+#include <string>
+#include <vector>
+
+namespace pplplus {
+    /*
+     Replaces FOR loops whose body is a single assignment with the list operations the
+     HP Prime runs natively.
+     
+     - L(i) := L(i)*2 + k for i from 1 to SIZE(L) becomes L := L*2 + k.
+     - L(i) := expression after L := {} becomes L := MAKELIST(expression, i, a, b).
+     - s := s + expression becomes s := s + ΣLIST(MAKELIST(expression, i, a, b)), and
+       s := s * expression likewise uses ΠLIST.
+     
+     MAKELIST is only used when the bounds are numbers and the loop runs at least once,
+     since it fails on an empty range where the loop would not. Any FOR loop that is
+     left alone is reported, with the reason why.
+     */
+    class Vectorizer {
+    public:
+        typedef struct TLoop {
+            std::string function;
+            long line;
+            std::string reason;
+        } TLoop;
+        
+        std::string vectorize(const std::string& code);
+        
+        // Loops rewritten by the last call to vectorize.
+        size_t vectorized(void) const {
+            return _vectorized;
+        }
+        
+        // FOR loops the last call to vectorize left alone.
+        const std::vector<TLoop>& skipped(void) const {
+            return _skipped;
+        }
+        
+    private:
+        size_t _vectorized = 0;
+        std::vector<TLoop> _skipped;
+    };
+}
+
+#endif // VECTORIZER_HPP
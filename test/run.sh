@@ -0,0 +1,29 @@
+#!/bin/sh
+#
+# Runs each program in test/run offline, without optimisation and with each optimisation
+# pass, and checks that every run returns the result given by its "// result:" comment
+# for the call given by its "// call:" comment.
+#
+# Usage: test/run.sh <ppl+>
+
+ppl="$1"
+dir="$(dirname "$0")/run"
+tmp="$(mktemp -d)"
+failed=0
+
+for file in "$dir"/*.prgm+; do
+    call="$(sed -n 's|^// call: ||p' "$file")"
+    expected="$(sed -n 's|^// result: ||p' "$file")"
+    for flags in "" "-c" "--tree-shake" "--inline" "--fold" "--hoist" "--cse" "--peephole" "--vectorize" "--dce" \
+                 "--tree-shake --inline --fold --hoist --cse --peephole --vectorize --dce"; do
+        result="$("$ppl" "$file" -o "$tmp/run.prgm" $flags --run "$call" 2>&1 | sed -n 's|^Result: ||p')"
+        if [ "$result" != "$expected" ]; then
+            echo "$(basename "$file") $flags: $call returned '$result', expected '$expected'"
+            failed=1
+        fi
+    done
+done
+
+rm -rf "$tmp"
+[ $failed = 0 ] && echo "All programs returned the expected results."
+exit $failed